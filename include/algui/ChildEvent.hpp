@@ -14,14 +14,17 @@ namespace algui {
      */
     template <class T> class ChildEvent : public ObjectEvent<T> {
     public:
+        ///event class tag.
+        static constexpr EventClassTag<ChildEvent<T>, ObjectEvent<T>> eventClass{};
+
         /**
          * The constructor.
          * @param type event type.
          * @param parent the parent.
          * @param child the child.
          */
-        ChildEvent(const std::string_view& type, std::shared_ptr<T>&& parent, const std::shared_ptr<T>& child)
-            : ObjectEvent<T>(type, std::move(parent))
+        ChildEvent(const EventType& type, std::shared_ptr<T>&& parent, const std::shared_ptr<T>& child)
+            : ObjectEvent<T>(type, eventClass, std::move(parent))
             , m_child(child)
         {
         }
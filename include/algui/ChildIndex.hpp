@@ -0,0 +1,129 @@
+#ifndef ALGUI_CHILDINDEX_HPP
+#define ALGUI_CHILDINDEX_HPP
+
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace algui {
+
+
+    /**
+     * Positional index of a sequence of entries, used by tree nodes to index their children.
+     *
+     * Entries are kept in chunks of bounded size, and the sizes of the chunks are summed up in a Fenwick tree;
+     * therefore, inserting before an entry and erasing an entry take time bounded by the chunk size,
+     * whereas finding the entry at an index and the index of an entry take logarithmic time.
+     * Splitting a full chunk and erasing an empty one take time linear to the number of chunks, which is amortized over the chunk size.
+     */
+    class ChildIndex {
+    private:
+        struct Chunk;
+
+    public:
+        /**
+         * Base class of indexed objects.
+         */
+        class Entry {
+        private:
+            //valid only while the entry is in an index
+            Chunk* m_chunk{ nullptr };
+            size_t m_position{ 0 };
+
+            friend class ChildIndex;
+        };
+
+        /**
+         * Maximum number of entries of a chunk.
+         */
+        static constexpr size_t CHUNK_SIZE = 128;
+
+        /**
+         * The default constructor.
+         */
+        ChildIndex();
+
+        /**
+         * The copy constructor.
+         * Deleted because entries can belong to one index only.
+         */
+        ChildIndex(const ChildIndex&) = delete;
+
+        /**
+         * The destructor.
+         */
+        ~ChildIndex();
+
+        /**
+         * The copy assignment operator.
+         * Deleted because entries can belong to one index only.
+         */
+        ChildIndex& operator = (const ChildIndex&) = delete;
+
+        /**
+         * Returns the number of entries.
+         * @return the number of entries.
+         */
+        size_t getSize() const;
+
+        /**
+         * Inserts an entry.
+         * @param entry entry to insert; must not be in an index.
+         * @param nextEntry entry to insert the given entry before; if null, the entry is appended.
+         */
+        void insert(Entry* entry, Entry* nextEntry = nullptr);
+
+        /**
+         * Erases an entry.
+         * @param entry entry to erase; must be in this index.
+         */
+        void erase(Entry* entry);
+
+        /**
+         * Erases all entries.
+         */
+        void clear();
+
+        /**
+         * Returns the entry at the given index.
+         * @param index index; must be less than the size.
+         * @return the entry at the given index.
+         */
+        Entry* getEntry(size_t index) const;
+
+        /**
+         * Returns the index of an entry.
+         * @param entry entry; must be in this index.
+         * @return the index of the entry.
+         */
+        size_t getIndex(const Entry* entry) const;
+
+    private:
+        struct Chunk {
+            std::vector<Entry*> entries;
+            size_t index;
+        };
+
+        std::vector<std::unique_ptr<Chunk>> m_chunks;
+
+        //Fenwick tree of chunk sizes, 1-based
+        std::vector<size_t> m_chunkSizes;
+
+        size_t m_size{ 0 };
+
+        void _insertChunk(size_t index);
+        void _eraseChunk(size_t index);
+        void _updateEntries(Chunk* chunk, size_t begin);
+        void _updateChunkSizes();
+        void _addChunkSize(size_t index, size_t size);
+        void _subtractChunkSize(size_t index, size_t size);
+        size_t _getOffset(size_t index) const;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_CHILDINDEX_HPP
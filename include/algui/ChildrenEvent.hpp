@@ -0,0 +1,49 @@
+#ifndef ALGUI_CHILDRENEVENT_HPP
+#define ALGUI_CHILDRENEVENT_HPP
+
+
+#include <vector>
+#include "ObjectEvent.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * Base class for object events that affect many children at once.
+     * @param T type of object.
+     */
+    template <class T> class ChildrenEvent : public ObjectEvent<T> {
+    public:
+        ///event class tag.
+        static constexpr EventClassTag<ChildrenEvent<T>, ObjectEvent<T>> eventClass{};
+
+        /**
+         * The constructor.
+         * @param type event type.
+         * @param parent the parent.
+         * @param children the children.
+         */
+        ChildrenEvent(const EventType& type, std::shared_ptr<T>&& parent, std::vector<std::shared_ptr<T>> children)
+            : ObjectEvent<T>(type, eventClass, std::move(parent))
+            , m_children(std::move(children))
+        {
+        }
+
+        /**
+         * Returns the affected children.
+         * @return the affected children.
+         */
+        const std::vector<std::shared_ptr<T>>& getChildren() const {
+            return m_children;
+        }
+
+    private:
+        std::vector<std::shared_ptr<T>> m_children;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_CHILDRENEVENT_HPP
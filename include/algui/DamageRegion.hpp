@@ -0,0 +1,78 @@
+#ifndef ALGUI_DAMAGEREGION_HPP
+#define ALGUI_DAMAGEREGION_HPP
+
+
+#include <cstddef>
+#include <vector>
+#include "Rect.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * A screen region that needs repainting, kept as a short list of non-overlapping rectangles.
+     *
+     * Added rectangles that overlap existing ones are merged with them into their union;
+     * when the list is full, a new rectangle is merged with the rectangle whose union with it grows the least.
+     * Therefore, the region might cover more area than what was added, but each area of it is painted once.
+     */
+    class DamageRegion {
+    public:
+        /**
+         * The default maximum number of rectangles.
+         */
+        static constexpr size_t DEFAULT_MAX_RECT_COUNT = 8;
+
+        /**
+         * The constructor.
+         * @param maxRectCount maximum number of rectangles; must not be 0.
+         * @exception std::invalid_argument thrown if the maximum number of rectangles is 0.
+         */
+        DamageRegion(size_t maxRectCount = DEFAULT_MAX_RECT_COUNT);
+
+        /**
+         * Returns the maximum number of rectangles.
+         * @return the maximum number of rectangles.
+         */
+        size_t getMaxRectCount() const {
+            return m_maxRectCount;
+        }
+
+        /**
+         * Returns the rectangles of the region.
+         * @return the rectangles of the region; they do not overlap.
+         */
+        const std::vector<Rect>& getRects() const {
+            return m_rects;
+        }
+
+        /**
+         * Checks if the region is empty.
+         * @return true if the region is empty, false otherwise.
+         */
+        bool isEmpty() const {
+            return m_rects.empty();
+        }
+
+        /**
+         * Adds a rectangle to the region.
+         * @param rect rectangle to add; invalid rectangles are ignored.
+         */
+        void add(const Rect& rect);
+
+        /**
+         * Empties the region.
+         */
+        void clear();
+
+    private:
+        size_t m_maxRectCount;
+        std::vector<Rect> m_rects;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_DAMAGEREGION_HPP
@@ -0,0 +1,59 @@
+#ifndef ALGUI_DELEGATEDEVENT_HPP
+#define ALGUI_DELEGATEDEVENT_HPP
+
+
+#include "Event.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * Event passed to delegated event listeners of an ancestor node.
+     * It wraps the event dispatched to a descendant node, i.e. the target.
+     * @param T type of node.
+     */
+    template <class T> class DelegatedEvent : public Event {
+    public:
+        ///event class tag.
+        static constexpr EventClassTag<DelegatedEvent<T>, Event> eventClass{};
+
+        /**
+         * The constructor.
+         * @param type event type.
+         * @param event the event dispatched to the target.
+         * @param target the node the event was dispatched to.
+         */
+        DelegatedEvent(const EventType& type, const Event& event, T* target)
+            : Event(type, eventClass)
+            , m_event(event)
+            , m_target(target)
+        {
+        }
+
+        /**
+         * Returns the event dispatched to the target.
+         * @return the event dispatched to the target.
+         */
+        const Event& getEvent() const {
+            return m_event;
+        }
+
+        /**
+         * Returns the node the event was dispatched to.
+         * @return the node the event was dispatched to.
+         */
+        T* getTarget() const {
+            return m_target;
+        }
+
+    private:
+        const Event& m_event;
+        T* m_target;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_DELEGATEDEVENT_HPP
@@ -0,0 +1,162 @@
+#ifndef ALGUI_DISPLAYLIST_HPP
+#define ALGUI_DISPLAYLIST_HPP
+
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include "Rect.hpp"
+
+
+namespace algui {
+
+
+    class UINode;
+
+
+    /**
+     * A recorded list of drawing commands.
+     *
+     * Nodes with an enabled display list (see `UINode::setDisplayListEnabled()`) record their `paint()` output into it,
+     * and the list is replayed on subsequent renders, as long as the node is not invalidated;
+     * unlike a cache bitmap, the list takes little memory, and it is replayed at the resolution of the target bitmap.
+     *
+     * Bitmaps and fonts are referenced, not copied; they must stay alive while they are recorded in the list.
+     */
+    class DisplayList {
+    public:
+        /**
+         * The default constructor.
+         * The list is empty.
+         */
+        DisplayList();
+
+        /**
+         * Records the drawing of a filled rectangle.
+         * @param x1 left coordinate.
+         * @param y1 top coordinate.
+         * @param x2 right coordinate.
+         * @param y2 bottom coordinate.
+         * @param color fill color.
+         */
+        void drawFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color);
+
+        /**
+         * Records the drawing of a rectangle outline.
+         * @param x1 left coordinate.
+         * @param y1 top coordinate.
+         * @param x2 right coordinate.
+         * @param y2 bottom coordinate.
+         * @param color outline color.
+         * @param thickness outline thickness; 0 for hairlines.
+         */
+        void drawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness);
+
+        /**
+         * Records the drawing of a line.
+         * @param x1 start horizontal coordinate.
+         * @param y1 start vertical coordinate.
+         * @param x2 end horizontal coordinate.
+         * @param y2 end vertical coordinate.
+         * @param color line color.
+         * @param thickness line thickness; 0 for hairlines.
+         */
+        void drawLine(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness);
+
+        /**
+         * Records the drawing of a bitmap.
+         * @param bitmap bitmap to draw.
+         * @param x horizontal coordinate.
+         * @param y vertical coordinate.
+         * @param flags allegro bitmap drawing flags.
+         */
+        void drawBitmap(ALLEGRO_BITMAP* bitmap, float x, float y, int flags);
+
+        /**
+         * Records the drawing of a scaled region of a bitmap.
+         * @param bitmap bitmap to draw.
+         * @param sx source horizontal coordinate.
+         * @param sy source vertical coordinate.
+         * @param sw source width.
+         * @param sh source height.
+         * @param dx destination horizontal coordinate.
+         * @param dy destination vertical coordinate.
+         * @param dw destination width.
+         * @param dh destination height.
+         * @param flags allegro bitmap drawing flags.
+         */
+        void drawScaledBitmap(ALLEGRO_BITMAP* bitmap, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh, int flags);
+
+        /**
+         * Records the drawing of text.
+         * @param font font of the text.
+         * @param color color of the text.
+         * @param x horizontal coordinate.
+         * @param y vertical coordinate.
+         * @param flags allegro text alignment flags.
+         * @param text text to draw; it is copied.
+         */
+        void drawText(const ALLEGRO_FONT* font, ALLEGRO_COLOR color, float x, float y, int flags, const std::string& text);
+
+        /**
+         * Returns the number of recorded commands.
+         * @return the number of recorded commands.
+         */
+        size_t getCommandCount() const {
+            return m_commands.size();
+        }
+
+        /**
+         * Checks if the list is empty.
+         * @return true if there are no recorded commands, false otherwise.
+         */
+        bool isEmpty() const {
+            return m_commands.empty();
+        }
+
+        /**
+         * Discards the recorded commands.
+         */
+        void clear();
+
+        /**
+         * Draws the recorded commands onto the target bitmap, in the order they were recorded, through the DrawBatch.
+         */
+        void replay() const;
+
+    private:
+        enum class CommandType {
+            FILLED_RECTANGLE,
+            RECTANGLE,
+            LINE,
+            BITMAP,
+            SCALED_BITMAP,
+            TEXT
+        };
+
+        //texts are stored in one buffer, null-terminated, and referenced by offset
+        struct Command {
+            CommandType type;
+            int flags;
+            ALLEGRO_COLOR color;
+            float args[8];
+            const void* resource;
+            size_t textOffset;
+        };
+
+        std::vector<Command> m_commands;
+        std::string m_texts;
+
+        //screen rectangle of the owner node, as of the last time the list was recorded
+        Rect m_screenRect;
+
+        friend class UINode;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_DISPLAYLIST_HPP
@@ -0,0 +1,133 @@
+#ifndef ALGUI_DRAWBATCH_HPP
+#define ALGUI_DRAWBATCH_HPP
+
+
+#include <cstddef>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+
+
+namespace algui {
+
+
+    /**
+     * Batching layer for drawing from many nodes.
+     *
+     * Primitives are collected into a shared vertex array, which is drawn by one `al_draw_prim()` call,
+     * and consecutive bitmap and text draws are deferred with `al_hold_bitmap_drawing()`, so that Allegro groups them by texture.
+     * The batch is flushed when switching between primitives and bitmaps, in order to preserve the painting order,
+     * when `Rect::setClippingRectangle()` changes the clipping rectangle, i.e. around clipped subtrees,
+     * and at the end of `UINode::render()`, `UINode::render(clipping)` and `UINode::renderDamaged()`.
+     *
+     * Code that draws with Allegro directly, or changes the target bitmap, the transformation or the blender,
+     * shall invoke `flush()` first.
+     * The batch shall be used from the UI thread only.
+     */
+    class DrawBatch {
+    public:
+        /**
+         * Batch statistics.
+         */
+        struct Statistics {
+            ///number of primitives drawn through the batch; rectangle outlines count as four primitives.
+            size_t primitiveCount{ 0 };
+
+            ///number of bitmaps and texts drawn through the batch.
+            size_t bitmapCount{ 0 };
+
+            ///number of `al_draw_prim()` calls.
+            size_t primitiveBatchCount{ 0 };
+
+            ///number of deferred bitmap drawing runs.
+            size_t bitmapBatchCount{ 0 };
+        };
+
+        /**
+         * Draws a filled rectangle.
+         * @param x1 left coordinate.
+         * @param y1 top coordinate.
+         * @param x2 right coordinate.
+         * @param y2 bottom coordinate.
+         * @param color fill color.
+         */
+        static void drawFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color);
+
+        /**
+         * Draws a rectangle outline, centered on the edges of the rectangle.
+         * @param x1 left coordinate.
+         * @param y1 top coordinate.
+         * @param x2 right coordinate.
+         * @param y2 bottom coordinate.
+         * @param color outline color.
+         * @param thickness outline thickness; 0 or less for lines of 1 pixel.
+         */
+        static void drawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness);
+
+        /**
+         * Draws a line.
+         * @param x1 start horizontal coordinate.
+         * @param y1 start vertical coordinate.
+         * @param x2 end horizontal coordinate.
+         * @param y2 end vertical coordinate.
+         * @param color line color.
+         * @param thickness line thickness; 0 or less for lines of 1 pixel.
+         */
+        static void drawLine(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness);
+
+        /**
+         * Draws a bitmap.
+         * @param bitmap bitmap to draw.
+         * @param x horizontal coordinate.
+         * @param y vertical coordinate.
+         * @param flags allegro bitmap drawing flags.
+         */
+        static void drawBitmap(ALLEGRO_BITMAP* bitmap, float x, float y, int flags);
+
+        /**
+         * Draws a scaled region of a bitmap.
+         * @param bitmap bitmap to draw.
+         * @param sx source horizontal coordinate.
+         * @param sy source vertical coordinate.
+         * @param sw source width.
+         * @param sh source height.
+         * @param dx destination horizontal coordinate.
+         * @param dy destination vertical coordinate.
+         * @param dw destination width.
+         * @param dh destination height.
+         * @param flags allegro bitmap drawing flags.
+         */
+        static void drawScaledBitmap(ALLEGRO_BITMAP* bitmap, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh, int flags);
+
+        /**
+         * Draws text.
+         * @param font font of the text.
+         * @param color color of the text.
+         * @param x horizontal coordinate.
+         * @param y vertical coordinate.
+         * @param flags allegro text alignment flags.
+         * @param text text to draw.
+         */
+        static void drawText(const ALLEGRO_FONT* font, ALLEGRO_COLOR color, float x, float y, int flags, const char* text);
+
+        /**
+         * Draws the collected primitives, and ends deferred bitmap drawing.
+         */
+        static void flush();
+
+        /**
+         * Returns the batch statistics.
+         * @return the batch statistics.
+         */
+        static Statistics getStatistics();
+
+        /**
+         * Resets the batch statistics.
+         */
+        static void resetStatistics();
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_DRAWBATCH_HPP
@@ -4,21 +4,84 @@
 
 #include <string_view>
 #include <utility>
+#include <typeinfo>
+#include <type_traits>
+#include "EventType.hpp"
 
 
 namespace algui {
 
 
+    /**
+     * Run-time information about an event class.
+     * Each event class has a unique instance of it, which allows checking the class of an event
+     * with pointer comparisons instead of `dynamic_cast`.
+     */
+    struct EventClass {
+        ///event class this event class derives from; null for the root event class.
+        const EventClass* base;
+    };
+
+
+    /**
+     * Event class tag.
+     * Event classes declare a `static constexpr EventClassTag<Class, BaseClass> eventClass{}` member,
+     * in order to receive events in listeners via `static_cast`.
+     * @param T the event class.
+     * @param Base the base event class; void for the root event class.
+     */
+    template <class T, class Base> struct EventClassTag : EventClass {
+        ///the event class.
+        using Type = T;
+
+        /**
+         * The constructor.
+         */
+        constexpr EventClassTag() : EventClass{ _getBase() } {
+        }
+
+    private:
+        static constexpr const EventClass* _getBase() {
+            if constexpr (std::is_void_v<Base>) {
+                return nullptr;
+            }
+            else {
+                return &Base::eventClass;
+            }
+        }
+    };
+
+
+    /**
+     * Checks if an event class declares its own event class tag.
+     * @param T the event class.
+     */
+    template <class T, class = void> struct HasEventClassTag : std::false_type {
+    };
+
+
+    /**
+     * Checks if an event class declares its own event class tag.
+     * @param T the event class.
+     */
+    template <class T> struct HasEventClassTag<T, std::void_t<decltype(T::eventClass)>>
+        : std::is_same<typename std::remove_cv_t<decltype(T::eventClass)>::Type, T> {
+    };
+
+
     /**
      * Base class for events.
      */
     class Event {
     public:
+        ///event class tag.
+        static constexpr EventClassTag<Event, void> eventClass{};
+
         /**
          * The constructor.
          * @param type event type.
          */
-        Event(const std::string_view& type) : m_type(type) {
+        Event(const EventType& type) : m_type(type), m_eventClass(&eventClass) {
         }
 
         /**
@@ -33,14 +96,79 @@ namespace algui {
          * @return the event type.
          */
         const std::string_view& getType() const {
+            return m_type.getName();
+        }
+
+        /**
+         * Returns the interned event type.
+         * @return the interned event type.
+         */
+        const EventType& getEventType() const {
             return m_type;
         }
 
+        /**
+         * Returns the class of this event.
+         * @return the class of this event.
+         */
+        const EventClass& getEventClass() const {
+            return *m_eventClass;
+        }
+
+        /**
+         * Checks if this event is of the given class, or of a class derived from it.
+         * @param eventClass the event class to check.
+         * @return true if this event is of the given class, false otherwise.
+         */
+        bool isA(const EventClass& eventClass) const {
+            for (const EventClass* c = m_eventClass; c; c = c->base) {
+                if (c == &eventClass) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    protected:
+        /**
+         * Constructor for derived event classes.
+         * @param type event type.
+         * @param eventClass class of the event.
+         */
+        Event(const EventType& type, const EventClass& eventClass) : m_type(type), m_eventClass(&eventClass) {
+        }
+
     private:
-        std::string_view m_type;
+        EventType m_type;
+        const EventClass* m_eventClass;
     };
 
 
+    /**
+     * Casts an event to the given event class.
+     * If the event class declares an event class tag (see `EventClassTag`), then the event is checked with `Event::isA`
+     * and converted via `static_cast`, otherwise it is converted via `dynamic_cast`.
+     * @param T the event class.
+     * @param event the event to cast.
+     * @return the event, as T.
+     * @exception std::bad_cast thrown if the event is not of class T.
+     */
+    template <class T> const T& eventCast(const Event& event) {
+        if constexpr (std::is_same_v<T, Event>) {
+            return event;
+        }
+        else if constexpr (HasEventClassTag<T>::value) {
+            if (!event.isA(T::eventClass)) {
+                throw std::bad_cast();
+            }
+            return static_cast<const T&>(event);
+        }
+        else {
+            return dynamic_cast<const T&>(event);
+        }
+    }
+
+
 } //namespace algui
 
 
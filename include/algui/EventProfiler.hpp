@@ -0,0 +1,148 @@
+#ifndef ALGUI_EVENTPROFILER_HPP
+#define ALGUI_EVENTPROFILER_HPP
+
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "EventTarget.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * Profile of an event type.
+     */
+    struct EventTypeProfile {
+        ///event type.
+        EventType eventType;
+
+        ///number of times events of this type were dispatched.
+        uint64_t dispatchCount{ 0 };
+
+        ///number of times event listeners were invoked for events of this type.
+        uint64_t listenerInvocationCount{ 0 };
+
+        ///total dispatch time, including the time of events dispatched from within listeners.
+        std::chrono::nanoseconds totalTime{ 0 };
+
+        ///maximum time of a single dispatch.
+        std::chrono::nanoseconds maxTime{ 0 };
+    };
+
+
+    /**
+     * Profile of an event listener.
+     */
+    struct EventListenerProfile {
+        ///event listener id; it might be stale.
+        EventTarget::EventListenerId id;
+
+        ///event type the event listener was added for.
+        EventType eventType;
+
+        ///number of times the event listener was invoked.
+        uint64_t invocationCount{ 0 };
+
+        ///total invocation time, including the time of events dispatched from within the event listener.
+        std::chrono::nanoseconds totalTime{ 0 };
+
+        ///maximum time of a single invocation.
+        std::chrono::nanoseconds maxTime{ 0 };
+    };
+
+
+    /**
+     * Snapshot of event dispatching statistics.
+     */
+    struct EventProfile {
+        ///profiles of dispatched event types, in event type id order.
+        std::vector<EventTypeProfile> eventTypes;
+
+        ///profiles of invoked event listeners; empty if event listener profiling is not enabled.
+        std::vector<EventListenerProfile> eventListeners;
+    };
+
+
+    /**
+     * Event dispatching profiler.
+     *
+     * It records dispatch counts, listener invocation counts and cumulative and maximum times per event type,
+     * and optionally per event listener, for every `EventTarget::dispatchEvent()` call.
+     *
+     * Recording happens only if the library is compiled with the macro `ALGUI_EVENT_PROFILING` defined;
+     * otherwise, the profiler does not record anything, and `EventTarget::dispatchEvent()` contains no profiling code.
+     *
+     * The profiler shall be used from the UI thread only.
+     */
+    class EventProfiler {
+    public:
+        /**
+         * Clock used for measuring time.
+         */
+        using Clock = std::chrono::steady_clock;
+
+        /**
+         * Checks if profiling is compiled in.
+         * @return true if the macro `ALGUI_EVENT_PROFILING` is defined, false otherwise.
+         */
+        static constexpr bool isEnabled() {
+#ifdef ALGUI_EVENT_PROFILING
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Checks if event listeners are profiled individually.
+         * The default is false.
+         * @return true if event listeners are profiled individually, false otherwise.
+         */
+        static bool isEventListenerProfilingEnabled();
+
+        /**
+         * Enables or disables profiling of individual event listeners.
+         * It requires timing each listener invocation separately, which is more expensive than timing each dispatch.
+         * @param v if true, event listeners are profiled individually.
+         */
+        static void setEventListenerProfilingEnabled(bool v);
+
+        /**
+         * Returns a snapshot of the statistics recorded so far.
+         * Event types and event listeners not dispatched since the last reset are not included.
+         * @param reset if true, the statistics are reset after the snapshot is taken.
+         * @return a snapshot of the statistics.
+         */
+        static EventProfile getProfile(bool reset = false);
+
+        /**
+         * Resets the statistics.
+         */
+        static void reset();
+
+        /**
+         * Records an event dispatch.
+         * Invoked by `EventTarget::dispatchEvent()`.
+         * @param eventType type of the dispatched event.
+         * @param listenerInvocationCount number of event listeners invoked.
+         * @param time duration of the dispatch.
+         */
+        static void recordDispatch(const EventType& eventType, size_t listenerInvocationCount, Clock::duration time);
+
+        /**
+         * Records an event listener invocation.
+         * Invoked by `EventTarget::dispatchEvent()`, if event listener profiling is enabled.
+         * @param id id of the event listener.
+         * @param eventType type of the dispatched event.
+         * @param time duration of the invocation.
+         */
+        static void recordListenerInvocation(const EventTarget::EventListenerId& id, const EventType& eventType, Clock::duration time);
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_EVENTPROFILER_HPP
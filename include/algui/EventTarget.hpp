@@ -2,10 +2,12 @@
 #define ALGUI_EVENTTARGET_HPP
 
 
-#include <map>
-#include <functional>
-#include <list>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <type_traits>
 #include "SharedObject.hpp"
+#include "SmallFunction.hpp"
 #include "Event.hpp"
 #include "FirstArgumentType.hpp"
 
@@ -20,56 +22,61 @@ namespace algui {
     public:
         /**
          * Event listener function.
+         * Small functors are stored in place, without a heap allocation.
          * @param event event to process.
          * @return true if event propagation should stop, false otherwise.
          */
-        using EventListenerFunction = std::function<bool(const Event& event)>;
+        using EventListenerFunction = SmallFunction<bool(const Event& event)>;
 
         /**
          * Id for event listeners.
+         * It is a small trivially copyable handle (an index plus a generation) into a global table of event listeners.
+         * When an event listener is removed, or its event target is destroyed, the ids that refer to it become stale.
+         * Event listeners shall be created and removed from the UI thread only.
          */
         class EventListenerId {
         public:
             /**
              * The default constructor.
+             * The id is invalid.
              */
             EventListenerId() {}
 
             /**
-             * The copy constructor.
-             * Deleted because there shall be only one owner of an event listener.
+             * Checks if the id refers to an existing event listener.
+             * @return true if the event listener exists, false if the id is invalid or stale.
              */
-            EventListenerId(const EventListenerId&) = delete;
+            bool isValid() const;
 
             /**
-             * The move constructor.
-             * @param id source object.
+             * Checks if the two ids are equal.
+             * @param id the other id to compare to this.
+             * @return true if they are equal, false otherwise.
              */
-            EventListenerId(EventListenerId&& id);
+            bool operator == (const EventListenerId& id) const {
+                return m_index == id.m_index && m_generation == id.m_generation;
+            }
 
             /**
-             * The copy assignment operator.
-             * Deleted because there shall be only one owner of an event listener.
+             * Checks if the two ids are different.
+             * @param id the other id to compare to this.
+             * @return true if they are different, false otherwise.
              */
-            EventListenerId& operator = (const EventListenerId&) = delete;
-
-            /**
-             * The move assignment operator.
-             * @param id source object.
-             * @return reference to this.
-             */
-            EventListenerId& operator = (EventListenerId&& id) noexcept;
+            bool operator != (const EventListenerId& id) const {
+                return m_index != id.m_index || m_generation != id.m_generation;
+            }
 
         private:
-            mutable EventTarget* m_eventTarget{nullptr};
-            std::string m_eventType;
-            std::list<EventListenerFunction>::iterator m_it;
-            EventListenerId(EventTarget* eventTarget, std::string&& eventType, std::list<EventListenerFunction>::iterator&& it);
+            uint32_t m_index{ 0 };
+            uint32_t m_generation{ 0 };
+            EventListenerId(uint32_t index, uint32_t generation) : m_index(index), m_generation(generation) {}
             friend class EventTarget;
+            friend class EventProfiler;
         };
 
         /**
          * Removes all event listener ids registered to this.
+         * The ids of the event listeners of this become stale.
          */
         virtual ~EventTarget();
 
@@ -80,28 +87,36 @@ namespace algui {
          * @param prioritized if true, the function will be executed before previously added functions, otherwise it will be executed after them.
          * @return an id for the event listener.
          */
-        EventListenerId addEventListener(std::string&& eventType, EventListenerFunction&& func, bool prioritized = false);
+        EventListenerId addEventListener(const EventType& eventType, EventListenerFunction&& func, bool prioritized = false);
 
         /**
          * Adds an event listener.
+         * If the event parameter type declares an event class tag (see `EventClassTag`),
+         * then events are checked with `Event::isA` and passed to the function via `static_cast`,
+         * otherwise they are passed via `dynamic_cast`.
          * @param eventType type of event.
          * @param func function to add; the event parameter can be any type derived from `class Event`.
          * @param prioritized if true, the function will be executed before previously added functions, otherwise it will be executed after them.
          * @return an id for the event listener.
          */
         template <class L>
-        EventListenerId addEventListener(std::string&& eventType, L&& func, bool prioritized = false) {
-            auto f = EventListenerFunction([func](const Event& e) {
-                using T = FirstArgumentType<L>;
-                return func(dynamic_cast<const T&>(e));
-            });
-            return addEventListener(std::move(eventType), std::move(f), prioritized);
+        EventListenerId addEventListener(const EventType& eventType, L&& func, bool prioritized = false) {
+            using T = std::remove_cv_t<std::remove_reference_t<FirstArgumentType<L>>>;
+            if constexpr (std::is_same_v<T, Event>) {
+                return addEventListener(eventType, EventListenerFunction(std::forward<L>(func)), prioritized);
+            }
+            else {
+                auto f = EventListenerFunction([func = std::forward<L>(func)](const Event& e) {
+                    return func(eventCast<T>(e));
+                });
+                return addEventListener(eventType, std::move(f), prioritized);
+            }
         }
 
         /**
          * Removes an event listener.
          * @param id id of event listener to remove.
-         * @exception std::invalid_argument thrown if the id is already removed or has not been created by this event target.
+         * @exception std::invalid_argument thrown if the id is stale or has not been created by this event target.
          */
         void removeEventListener(const EventListenerId& id);
 
@@ -114,16 +129,85 @@ namespace algui {
          */
         bool dispatchEvent(const Event& event) const;
 
+        /**
+         * Dispatches an event, if there are event listeners for its type.
+         * The event is created only if there are event listeners for the given event type,
+         * so that it costs nothing to dispatch events that nobody listens to.
+         * @param eventType type of event.
+         * @param createEvent function that returns the event to dispatch; the returned event must have the given type.
+         * @return true if propagation stopped, false otherwise.
+         * @exception std::bad_cast thrown if an event handler's first argument type does not match the underlying type of the created event.
+         */
+        template <class F> bool dispatchEvent(const EventType& eventType, F&& createEvent) const {
+            return hasEventListeners(eventType) && dispatchEvent(createEvent());
+        }
+
+        /**
+         * Checks if there are event listeners for the given event type.
+         * @param eventType type of event.
+         * @return true if there is at least one event listener for the given event type, false otherwise.
+         */
+        bool hasEventListeners(const EventType& eventType) const {
+            const size_t eventTypeId = eventType.getId();
+            return eventTypeId < m_eventListenerQueues.size() && m_eventListenerQueues[eventTypeId].first;
+        }
+
+        /**
+         * Returns the union of the masks of the event types this has event listeners for.
+         * @return the union of the masks of the event types this has event listeners for (see `EventType::getMask()`).
+         */
+        uint64_t getEventListenerMask() const;
+
         /**
          * Adds an event listener id to this object.
-         * The event listener will automatically be removed from its event target when this event target goes out of scope.
+         * The event listener will automatically be removed from its event target when this event target goes out of scope,
+         * unless the id is stale by then.
          * @param id the event listener id to add to this object.
          */
-        void addEventListenerId(EventListenerId&& id);
+        void addEventListenerId(EventListenerId id);
+
+    protected:
+        /**
+         * Invoked when the first event listener for an event type is added.
+         * The default implementation does nothing.
+         * @param eventTypeId id of the event type.
+         */
+        virtual void firstEventListenerAdded(size_t eventTypeId) {
+        }
+
+        /**
+         * Invoked when the last event listener for an event type is removed.
+         * The default implementation does nothing.
+         * @param eventTypeId id of the event type.
+         */
+        virtual void lastEventListenerRemoved(size_t eventTypeId) {
+        }
 
     private:
-        std::map<std::string, std::list<EventListenerFunction>, std::less<>> m_eventListenerFunctions;
+        //listeners are stored in chunks, so that they are not moved while being executed;
+        //a removed listener has its prev pointer set to itself.
+        struct EventListener {
+            EventListenerFunction function;
+            EventListener* prev;
+            EventListener* next;
+            uint32_t idIndex;
+        };
+
+        struct EventListenerQueue {
+            EventListener* first{ nullptr };
+            EventListener* last{ nullptr };
+        };
+
+        std::vector<EventListenerQueue> m_eventListenerQueues;
+        std::vector<std::unique_ptr<EventListener[]>> m_eventListenerChunks;
+        EventListener* m_freeEventListener{ nullptr };
+        std::vector<EventListener*> m_removedEventListeners;
+        mutable size_t m_dispatchDepth{ 0 };
         std::vector<EventListenerId> m_eventListenerIds;
+
+        EventListener* _allocEventListener();
+        void _removeEventListener(EventListener* listener, size_t eventTypeId);
+        void _freeRemovedEventListeners();
     };
 
 
@@ -0,0 +1,121 @@
+#ifndef ALGUI_EVENTTYPE_HPP
+#define ALGUI_EVENTTYPE_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+namespace algui {
+
+
+    /**
+     * An interned event type.
+     *
+     * Event type names are registered once into a global registry and mapped to small integer ids,
+     * allowing event dispatching to use array lookups instead of string comparisons.
+     *
+     * Ids are assigned in registration order, starting from 0.
+     * Event types are never unregistered.
+     *
+     * Registration is thread-safe; event types can be created from any thread.
+     */
+    class EventType {
+    public:
+        /**
+         * Constructor from name.
+         * If the name is not registered, it is registered.
+         * @param name name of the event type.
+         */
+        EventType(const std::string_view& name);
+
+        /**
+         * Constructor from name.
+         * @param name name of the event type.
+         */
+        EventType(const char* name) : EventType(std::string_view(name)) {
+        }
+
+        /**
+         * Constructor from name.
+         * @param name name of the event type.
+         */
+        EventType(const std::string& name) : EventType(std::string_view(name)) {
+        }
+
+        /**
+         * Returns the id of the event type.
+         * @return the id of the event type.
+         */
+        size_t getId() const {
+            return m_entry->id;
+        }
+
+        /**
+         * Returns the name of the event type.
+         * @return the name of the event type.
+         */
+        const std::string_view& getName() const {
+            return m_entry->name;
+        }
+
+        /**
+         * Returns the bit mask of the event type.
+         * Used for summarizing sets of event types in 64 bits;
+         * event types whose ids differ by a multiple of 64 share the same bit.
+         * @return the bit mask of the event type.
+         */
+        uint64_t getMask() const {
+            return getMask(m_entry->id);
+        }
+
+        /**
+         * Returns the bit mask of an event type id.
+         * @param id event type id.
+         * @return the bit mask of the given event type id.
+         */
+        static uint64_t getMask(size_t id) {
+            return uint64_t(1) << (id % 64);
+        }
+
+        /**
+         * Returns the number of registered event types.
+         * @return the number of registered event types.
+         */
+        static size_t getCount();
+
+        /**
+         * Checks if the two event types are equal.
+         * @param t the other event type to compare to this.
+         * @return true if they are equal, false otherwise.
+         */
+        bool operator == (const EventType& t) const {
+            return m_entry == t.m_entry;
+        }
+
+        /**
+         * Checks if the two event types are different.
+         * @param t the other event type to compare to this.
+         * @return true if they are different, false otherwise.
+         */
+        bool operator != (const EventType& t) const {
+            return m_entry != t.m_entry;
+        }
+
+    private:
+        struct Entry {
+            std::string storage;
+            std::string_view name;
+            size_t id;
+        };
+
+        const Entry* m_entry;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_EVENTTYPE_HPP
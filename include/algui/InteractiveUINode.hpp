@@ -6,6 +6,9 @@
 #include <vector>
 #include <allegro5/allegro.h>
 #include "UINode.hpp"
+#include "PostedEventQueue.hpp"
+#include "UICommandQueue.hpp"
+#include "DelegatedEvent.hpp"
 #include "algui/MouseEvent.hpp"
 #include "algui/KeyboardEvent.hpp"
 
@@ -39,6 +42,13 @@ namespace algui {
      */
     class InteractiveUINode : public UINode {
     public:
+        /**
+         * Filter for delegated event listeners.
+         * @param node the descendant node an event is dispatched to.
+         * @return true if the delegated event listener shall be invoked for the given node, false otherwise.
+         */
+        using DelegatedEventFilter = SmallFunction<bool(const InteractiveUINode& node)>;
+
         /**
          * The destructor.
          * If this is the focused node, then the internal focused node pointer is reset.
@@ -46,16 +56,24 @@ namespace algui {
         virtual ~InteractiveUINode();
 
         /**
-         * In addition to base class `render()`, it adds rendering of dragged images.
+         * In addition to base class `render()`, it applies the submitted command buffers and dispatches a batch of posted events, before rendering,
+         * and adds rendering of dragged images.
          */
         void render() override;
 
         /**
-         * In addition to base class `render(clipping)`, it adds rendering of dragged images.
+         * In addition to base class `render(clipping)`, it applies the submitted command buffers and dispatches a batch of posted events, before rendering,
+         * and adds rendering of dragged images.
          * @param clipping screen clipping.
          */
         void render(const Rect& clipping) override;
 
+        /**
+         * In addition to base class `renderDamaged()`, it applies the submitted command buffers and dispatches a batch of posted events, before rendering.
+         * While images are dragged, and right after, the whole tree is rendered instead, since the dragged images move over it.
+         */
+        void renderDamaged() override;
+
         /**
          * Returns a pointer to the closest ancestor node that is an interactive UI node.
          * @return a pointer to the closest ancestor node that is an interactive UI node.
@@ -283,6 +301,37 @@ namespace algui {
          */
         static bool setDraggedImages(std::vector<DraggedImage>* images);
 
+        /**
+         * Returns the queue of events posted to this tree from other threads.
+         * The queue is created on the first call; it shall be retrieved from the UI thread,
+         * and then it can be passed to other threads, which can post events to it.
+         * The queue is attached to the node on which `doEvent()` and `render()` are invoked, i.e. the root.
+         * @return the posted event queue of this.
+         */
+        const std::shared_ptr<PostedEventQueue>& getPostedEventQueue();
+
+        /**
+         * Sets the queue of events posted to this tree from other threads.
+         * @param queue the posted event queue; it can be null.
+         */
+        void setPostedEventQueue(const std::shared_ptr<PostedEventQueue>& queue);
+
+        /**
+         * Returns the queue of command buffers submitted to this tree from other threads.
+         * The queue is created on the first call; it shall be retrieved from the UI thread,
+         * and then it can be passed to other threads, which can submit command buffers to it.
+         * The queue is attached to the node on which `render()` is invoked, i.e. the root;
+         * the submitted command buffers are applied at the start of `render()`, before the posted events are dispatched.
+         * @return the command queue of this.
+         */
+        const std::shared_ptr<UICommandQueue>& getCommandQueue();
+
+        /**
+         * Sets the queue of command buffers submitted to this tree from other threads.
+         * @param queue the command queue; it can be null.
+         */
+        void setCommandQueue(const std::shared_ptr<UICommandQueue>& queue);
+
         /**
          * Handles the given allegro event and creates events for this UI tree.
          * The node must be enabled in order to handle events.
@@ -306,11 +355,55 @@ namespace algui {
          *  - ALLEGRO_EVENT_DISPLAY_EXPOSE:
          *      Renders this tree with the clipping rectangle defined in the expose event.
          * 
+         * Before handling the allegro event, a batch of events posted to the posted event queue of this, if any, is dispatched.
+         * 
          * @param event allegro event to handle.
          * @return true if the event was handled, false otherwise.
          */
         virtual bool doEvent(const ALLEGRO_EVENT& event);
 
+        /**
+         * Adds a delegated event listener.
+         *
+         * A delegated event listener is invoked for events that `doEvent()` dispatches to interactive descendants of this,
+         * i.e. mouse, drag-n-drop, keyboard and timer events, as if it was added to each descendant accepted by the filter.
+         * It is invoked right after the event listeners of the descendant (in both capture and bubble phases),
+         * with the descendant as target, unless propagation is stopped.
+         * Delegated event listeners of closer ancestors are invoked first.
+         *
+         * It allows handling events of large repeated structures (e.g. rows of a list) with one event listener.
+         *
+         * Delegated event listeners are removed with `removeEventListener()`.
+         *
+         * @param eventType type of event.
+         * @param filter function that selects the descendants for which the listener is invoked.
+         * @param func function to add; its first parameter is the event (of any type derived from `class Event`),
+         *  and its second parameter is the target, as `InteractiveUINode*`.
+         * @param prioritized if true, the function will be executed before previously added delegated functions, otherwise it will be executed after them.
+         * @return an id for the event listener.
+         */
+        template <class L>
+        EventListenerId addDelegatedEventListener(const EventType& eventType, DelegatedEventFilter&& filter, L&& func, bool prioritized = false) {
+            using T = std::remove_cv_t<std::remove_reference_t<FirstArgumentType<L>>>;
+            auto f = [filter = std::move(filter), func = std::forward<L>(func)](const DelegatedEvent<InteractiveUINode>& e) {
+                return filter(*e.getTarget()) && func(eventCast<T>(e.getEvent()), e.getTarget());
+            };
+            return addEventListener(_getDelegatedEventType(eventType), std::move(f), prioritized);
+        }
+
+        /**
+         * Adds a delegated event listener that is invoked for descendants of class N.
+         * @param N class of descendants; the listener is invoked for descendants that are of class N or of a class derived from N.
+         * @param eventType type of event.
+         * @param func function to add; see the other overload.
+         * @param prioritized if true, the function will be executed before previously added delegated functions, otherwise it will be executed after them.
+         * @return an id for the event listener.
+         */
+        template <class N, class L>
+        EventListenerId addDelegatedEventListener(const EventType& eventType, L&& func, bool prioritized = false) {
+            return addDelegatedEventListener(eventType, [](const InteractiveUINode& node) { return node.as<N>() != nullptr; }, std::forward<L>(func), prioritized);
+        }
+
     protected:
         /**
          * Sets the new child state.
@@ -319,22 +412,30 @@ namespace algui {
         void setNewChildState(const std::shared_ptr<UINode>& child) override;
 
     private:
+        class _EventPath;
+
         int m_flags{1};
+        std::shared_ptr<PostedEventQueue> m_postedEventQueue;
+        std::shared_ptr<UICommandQueue> m_commandQueue;
 
+        void _dispatchFocusEvent(const EventType& type);
+        static const EventType& _getDelegatedEventType(const EventType& type);
         static void _setEnabledTree(UINode* node, bool parentEnabledTree);
         static void _setFocusedTree(UINode* node, bool parentFocusedTree = false);
         static void _setHighlightedTree(UINode* node, bool parentHighlightedTree = false);
         static void _setPressedTree(UINode* node, bool parentPressedTree = false);
         static void _setSelectedTree(UINode* node, bool parentSelectedTree = false);
         static void _setErrorTree(UINode* node, bool parentErrorTree = false);
-        static bool _doRootMouseMoveEvent(const std::string_view& type, const std::string_view& enterType, const std::string_view& leaveType, UINode* node, const ALLEGRO_EVENT& event);
-        static bool _doMouseEnterEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event);
-        static bool _doMouseMoveEvent(const std::string_view& type, const std::string_view& enterType, const std::string_view& leaveType, UINode* node, const ALLEGRO_EVENT& event);
-        static bool _doMouseLeaveEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event);
-        static bool _doMouseButtonEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event);
-        static bool _doRootKeyboardEvent(const std::string_view& type, InteractiveUINode* node, const ALLEGRO_EVENT& event);
-        static bool _doKeyboardEvent(const std::string_view& type, UINode* node, const KeyboardEvent& event);
-        static bool _doDragKeyEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event, const ALLEGRO_EVENT& mouseEvent);
+        static bool _doRootMouseMoveEvent(const EventType& type, const EventType& enterType, const EventType& leaveType, UINode* node, const ALLEGRO_EVENT& event);
+        static bool _doMouseEnterEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path);
+        static bool _doMouseMoveEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path, _EventPath& enterPath, _EventPath& leavePath);
+        static bool _doMouseLeaveEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path);
+        static bool _doRootMouseButtonEvent(const EventType& type, UINode* node, const ALLEGRO_EVENT& event);
+        static bool _doMouseButtonEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path);
+        static bool _doRootKeyboardEvent(const EventType& type, InteractiveUINode* node, const ALLEGRO_EVENT& event);
+        static bool _doKeyboardEvent(const EventType& type, UINode* node, const KeyboardEvent& event);
+        static bool _doRootDragKeyEvent(const EventType& type, UINode* node, const ALLEGRO_EVENT& event, const ALLEGRO_EVENT& mouseEvent);
+        static bool _doDragKeyEvent(UINode* node, const KeyboardEvent& event, const ALLEGRO_EVENT& mouseEvent, _EventPath& path);
         static bool _doTimerEvent(UINode* node, const Event& event);
 
 };
@@ -14,6 +14,9 @@ namespace algui {
      */
     class KeyboardEvent : public Event {
     public:
+        ///event class tag.
+        static constexpr EventClassTag<KeyboardEvent, Event> eventClass{};
+
         /**
          * Constructor.
          * @param type type of event.
@@ -23,8 +26,8 @@ namespace algui {
          * @param modifiers ALLEGRO modifiers bitfield.
          * @param repeated if event is repeated.
          */
-        KeyboardEvent(const std::string_view& type, int keycode, int char_, unsigned int modifiers, bool repeated)
-            : Event(type)
+        KeyboardEvent(const EventType& type, int keycode, int char_, unsigned int modifiers, bool repeated)
+            : Event(type, eventClass)
             , m_keycode(keycode)
             , m_char(char_)
             , m_modifiers(modifiers)
@@ -14,6 +14,9 @@ namespace algui {
      */
     class MouseEvent : public Event {
     public:
+        ///event class tag.
+        static constexpr EventClassTag<MouseEvent, Event> eventClass{};
+
         /**
          * Constructor.
          * @param type type of eevent.
@@ -24,8 +27,8 @@ namespace algui {
          * @param button mouse button.
          * @param capture capture phase flag.
          */
-        MouseEvent(const std::string_view& type, int x, int y, int z, int w, int button, bool capture)
-            : Event(type)
+        MouseEvent(const EventType& type, int x, int y, int z, int w, int button, bool capture)
+            : Event(type, eventClass)
             , m_x(x)
             , m_y(y)
             , m_z(z)
@@ -16,13 +16,16 @@ namespace algui {
      */
     template <class T> class ObjectEvent : public Event {
     public:
+        ///event class tag.
+        static constexpr EventClassTag<ObjectEvent<T>, Event> eventClass{};
+
         /**
          * The constructor.
          * @param type event type.
          * @param object the object.
          */
-        ObjectEvent(const std::string_view& type, std::shared_ptr<T>&& object)
-            : Event(type)
+        ObjectEvent(const EventType& type, std::shared_ptr<T>&& object)
+            : Event(type, eventClass)
             , m_object(std::move(object))
         {
         }
@@ -35,6 +38,19 @@ namespace algui {
             return m_object;
         }
 
+    protected:
+        /**
+         * Constructor for derived event classes.
+         * @param type event type.
+         * @param eventClass class of the event.
+         * @param object the object.
+         */
+        ObjectEvent(const EventType& type, const EventClass& eventClass, std::shared_ptr<T>&& object)
+            : Event(type, eventClass)
+            , m_object(std::move(object))
+        {
+        }
+
     private:
         std::shared_ptr<T> m_object;
     };
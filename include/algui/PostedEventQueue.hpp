@@ -0,0 +1,127 @@
+#ifndef ALGUI_POSTEDEVENTQUEUE_HPP
+#define ALGUI_POSTEDEVENTQUEUE_HPP
+
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include "EventTarget.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * A queue of events posted from any thread, to be dispatched to event targets in the UI thread.
+     *
+     * It is a multiple-producer, single-consumer lock-free queue:
+     * events can be posted from any number of threads concurrently, without blocking,
+     * whereas events are dispatched only from the UI thread.
+     *
+     * Events are addressed to event targets via weak pointers;
+     * events posted to targets that no longer exist when the events are dispatched are discarded.
+     *
+     * Events posted from the same thread are dispatched in the order they were posted.
+     */
+    class PostedEventQueue {
+    public:
+        /**
+         * The default batch size.
+         */
+        static constexpr size_t DEFAULT_BATCH_SIZE = 256;
+
+        /**
+         * The default constructor.
+         */
+        PostedEventQueue();
+
+        /**
+         * The copy constructor.
+         * Deleted because the queue is meant to be shared.
+         */
+        PostedEventQueue(const PostedEventQueue&) = delete;
+
+        /**
+         * The destructor.
+         * Events not yet dispatched are discarded.
+         */
+        ~PostedEventQueue();
+
+        /**
+         * The copy assignment operator.
+         * Deleted because the queue is meant to be shared.
+         */
+        PostedEventQueue& operator = (const PostedEventQueue&) = delete;
+
+        /**
+         * Posts an event.
+         * It can be called from any thread; it never blocks, apart from allocating memory.
+         * @param target target of the event.
+         * @param event event to post; must not be null.
+         * @exception std::invalid_argument thrown if the event is null.
+         */
+        void post(std::weak_ptr<EventTarget> target, std::unique_ptr<Event> event);
+
+        /**
+         * Posts an event.
+         * It can be called from any thread; it never blocks, apart from allocating memory.
+         * @param target target of the event.
+         * @param args arguments to the event constructor.
+         */
+        template <class E, class... A> void post(std::weak_ptr<EventTarget> target, A&&... args) {
+            post(std::move(target), std::make_unique<E>(std::forward<A>(args)...));
+        }
+
+        /**
+         * Returns the maximum number of events dispatched by `dispatchEvents()`.
+         * @return the maximum number of events dispatched by `dispatchEvents()`.
+         */
+        size_t getBatchSize() const {
+            return m_batchSize;
+        }
+
+        /**
+         * Sets the maximum number of events dispatched by `dispatchEvents()`.
+         * @param size the maximum number of events dispatched by `dispatchEvents()`; must not be 0.
+         * @exception std::invalid_argument thrown if the size is 0.
+         */
+        void setBatchSize(size_t size);
+
+        /**
+         * Dispatches up to `getBatchSize()` posted events.
+         * It must be called from the UI thread only.
+         * @return number of events removed from the queue.
+         */
+        size_t dispatchEvents() {
+            return dispatchEvents(m_batchSize);
+        }
+
+        /**
+         * Dispatches posted events.
+         * It must be called from the UI thread only.
+         * @param maxCount maximum number of events to dispatch.
+         * @return number of events removed from the queue.
+         */
+        size_t dispatchEvents(size_t maxCount);
+
+    private:
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            std::weak_ptr<EventTarget> target;
+            std::unique_ptr<Event> event;
+        };
+
+        std::atomic<Node*> m_head;
+        Node* m_tail;
+        Node m_stub;
+        size_t m_batchSize{ DEFAULT_BATCH_SIZE };
+
+        void _push(Node* node);
+        Node* _pop();
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_POSTEDEVENTQUEUE_HPP
@@ -196,15 +196,40 @@ namespace algui {
 
         /**
          * Stores the current bitmap clipping into a rectangle.
-         * @return a rectangle with the current bitmap clipping.
+         * @return a rectangle with the current bitmap clipping, in screen coordinates.
          */
         static Rect getClippingRectangle();
 
         /**
          * Sets the current bitmap clipping from this rectangle.
+         * The rectangle is in screen coordinates.
+         * If the clipping changes, the DrawBatch is flushed first.
          */
         void setClippingRectangle() const;
 
+        /**
+         * Returns the horizontal screen coordinate of the top-left corner of the target bitmap.
+         * The default is 0.
+         * @return the horizontal clipping origin.
+         */
+        static float getClippingOriginX();
+
+        /**
+         * Returns the vertical screen coordinate of the top-left corner of the target bitmap.
+         * The default is 0.
+         * @return the vertical clipping origin.
+         */
+        static float getClippingOriginY();
+
+        /**
+         * Sets the screen coordinates of the top-left corner of the target bitmap.
+         * Clipping rectangles are translated by the origin when set and got,
+         * so that screen rectangles clip correctly when a part of the screen is rendered into an offscreen bitmap.
+         * @param x horizontal clipping origin.
+         * @param y vertical clipping origin.
+         */
+        static void setClippingOrigin(float x, float y);
+
         /**
          * Checks if the two rectangles are equal.
          * @param r the other rectangle to compare to this.
@@ -0,0 +1,175 @@
+#ifndef ALGUI_RENDERCACHE_HPP
+#define ALGUI_RENDERCACHE_HPP
+
+
+#include <cstddef>
+#include <allegro5/allegro.h>
+#include "Rect.hpp"
+
+
+namespace algui {
+
+
+    class UINode;
+
+
+    /**
+     * Bitmaps of UI subtrees rendered offscreen.
+     *
+     * A cached node (see `UINode::setCached()`) renders its subtree into a bitmap of the cache,
+     * and then, while nothing in the subtree changes, blits the bitmap instead of painting the subtree.
+     * The bitmaps of all cached nodes share a memory budget; when a new bitmap does not fit,
+     * the least recently used bitmaps are released, and if it still does not fit, the subtree is painted directly.
+     *
+     * The cache shall be used from the UI thread only.
+     */
+    class RenderCache {
+    public:
+        /**
+         * Cache statistics.
+         */
+        struct Statistics {
+            ///number of renders of cached nodes that blitted a valid bitmap.
+            size_t hitCount{ 0 };
+
+            ///number of renders of cached nodes that had to paint their subtree.
+            size_t missCount{ 0 };
+
+            ///number of bitmaps held.
+            size_t bitmapCount{ 0 };
+
+            ///estimated memory of the bitmaps held, in bytes.
+            size_t byteCount{ 0 };
+
+            /**
+             * Returns the ratio of hits to renders.
+             * @return the hit rate, from 0 to 1; 0 if there were no renders.
+             */
+            double getHitRate() const {
+                return hitCount + missCount ? (double)hitCount / (double)(hitCount + missCount) : 0.0;
+            }
+
+            /**
+             * Returns the ratio of misses to renders.
+             * @return the miss rate, from 0 to 1; 0 if there were no renders.
+             */
+            double getMissRate() const {
+                return hitCount + missCount ? (double)missCount / (double)(hitCount + missCount) : 0.0;
+            }
+        };
+
+        /**
+         * The default memory budget, in bytes.
+         */
+        static constexpr size_t DEFAULT_MAX_BYTE_COUNT = 64 * 1024 * 1024;
+
+        /**
+         * Bitmap slot of a cached node.
+         */
+        class Entry {
+        public:
+            /**
+             * The default constructor.
+             * The entry has no bitmap.
+             */
+            Entry();
+
+            /**
+             * The copy constructor.
+             * Deleted because entries are linked into the cache.
+             */
+            Entry(const Entry&) = delete;
+
+            /**
+             * The destructor.
+             * The bitmap of the entry, if any, is released.
+             */
+            ~Entry();
+
+            /**
+             * The copy assignment operator.
+             * Deleted because entries are linked into the cache.
+             */
+            Entry& operator = (const Entry&) = delete;
+
+            /**
+             * Returns the bitmap of the entry.
+             * @return the bitmap of the entry; null if there is none.
+             */
+            ALLEGRO_BITMAP* getBitmap() const {
+                return m_bitmap;
+            }
+
+        private:
+            ALLEGRO_BITMAP* m_bitmap;
+            int m_width;
+            int m_height;
+
+            //screen position of the bitmap
+            int m_left;
+            int m_top;
+
+            //screen rectangle of the node, as of the last time the bitmap was rendered
+            Rect m_screenRect;
+
+            //true when the bitmap contains a completed render
+            bool m_valid;
+
+            //entries being rendered into are not evicted
+            bool m_locked;
+
+            //links of the list of entries with bitmaps, from the least to the most recently used
+            Entry* m_prev;
+            Entry* m_next;
+
+            friend class RenderCache;
+            friend class UINode;
+        };
+
+        /**
+         * Returns the memory budget.
+         * @return the memory budget, in bytes.
+         */
+        static size_t getMaxByteCount();
+
+        /**
+         * Sets the memory budget.
+         * Bitmaps that exceed the new budget are released, least recently used first.
+         * @param count the new memory budget, in bytes.
+         */
+        static void setMaxByteCount(size_t count);
+
+        /**
+         * Returns the cache statistics.
+         * @return the cache statistics.
+         */
+        static Statistics getStatistics();
+
+        /**
+         * Resets the hit and miss counts.
+         */
+        static void resetStatistics();
+
+        /**
+         * Releases all bitmaps.
+         * Cached nodes render their subtrees again the next time they are rendered.
+         */
+        static void clear();
+
+    private:
+        static bool _acquire(Entry& entry, int width, int height);
+        static void _release(Entry& entry);
+        static void _hit(Entry& entry);
+        static void _miss();
+        static void _evict(size_t maxByteCount);
+        static void _link(Entry& entry);
+        static void _unlink(Entry& entry);
+
+        friend class UINode;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_RENDERCACHE_HPP
@@ -0,0 +1,124 @@
+#ifndef ALGUI_RENDERSNAPSHOT_HPP
+#define ALGUI_RENDERSNAPSHOT_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Rect.hpp"
+
+
+namespace algui {
+
+
+    class UINode;
+
+
+    /**
+     * Flattened snapshot of a UI tree, used for rendering.
+     *
+     * The nodes of the tree are stored in pre-order, and their render data are stored in parallel arrays;
+     * therefore, skipping a subtree is a jump to the end index of the subtree,
+     * and culling and clipping read contiguous memory instead of following the links of the nodes.
+     *
+     * The snapshot is rebuilt when the structure of its tree changes; unchanged subtrees are copied from the previous snapshot.
+     * The screen rectangles are refreshed from the nodes only by the walks that follow a change in the geometry of the tree.
+     */
+    class RenderSnapshot {
+    public:
+        /**
+         * Flags of snapshot entries.
+         */
+        enum FLAGS {
+            ///the node is visible.
+            VISIBLE = 1 << 0,
+
+            ///the node clips its children.
+            CLIPPED = 1 << 1,
+
+            ///the node is rendered through a render cache.
+            CACHED = 1 << 2
+        };
+
+        /**
+         * The default constructor.
+         * The snapshot is empty.
+         */
+        RenderSnapshot();
+
+        /**
+         * The copy constructor.
+         * Deleted because nodes can belong to one snapshot at a time.
+         */
+        RenderSnapshot(const RenderSnapshot&) = delete;
+
+        /**
+         * The copy assignment operator.
+         * Deleted because nodes can belong to one snapshot at a time.
+         */
+        RenderSnapshot& operator = (const RenderSnapshot&) = delete;
+
+        /**
+         * Returns the number of entries.
+         * @return the number of entries.
+         */
+        size_t getSize() const {
+            return m_nodes.size();
+        }
+
+        /**
+         * Returns the nodes, in pre-order.
+         * @return the nodes.
+         */
+        const std::vector<UINode*>& getNodes() const {
+            return m_nodes;
+        }
+
+        /**
+         * Returns the screen rectangles of the nodes, as of the last time the nodes were rendered through this snapshot.
+         * @return the screen rectangles of the nodes.
+         */
+        const std::vector<Rect>& getScreenRects() const {
+            return m_screenRects;
+        }
+
+        /**
+         * Returns the flags of the nodes.
+         * @return the flags of the nodes.
+         */
+        const std::vector<uint8_t>& getFlags() const {
+            return m_flags;
+        }
+
+        /**
+         * Returns the subtree end indices, i.e. the index of the first entry after the subtree of each node.
+         * @return the subtree end indices.
+         */
+        const std::vector<uint32_t>& getSubtreeEnds() const {
+            return m_subtreeEnds;
+        }
+
+    private:
+        //identifies the snapshot in the nodes that belong to it
+        uint32_t m_id;
+
+        //structure epoch the snapshot was built in; subtrees stamped with it or later changed after the build
+        size_t m_structureEpoch;
+
+        //geometry epoch of the last walk that refreshed the screen rects; subtrees stamped with it or later changed after the walk;
+        //0 if the screen rects must be refreshed
+        size_t m_geometryEpoch;
+
+        std::vector<UINode*> m_nodes;
+        std::vector<Rect> m_screenRects;
+        std::vector<uint8_t> m_flags;
+        std::vector<uint32_t> m_subtreeEnds;
+
+        friend class UINode;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_RENDERSNAPSHOT_HPP
@@ -0,0 +1,200 @@
+#ifndef ALGUI_SMALLFUNCTION_HPP
+#define ALGUI_SMALLFUNCTION_HPP
+
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+
+namespace algui {
+
+
+    template <class Signature, size_t Size = 4 * sizeof(void*)> class SmallFunction;
+
+
+    /**
+     * A move-only function wrapper with a small buffer.
+     * Functors that fit in the buffer and are nothrow move constructible are stored in place,
+     * without a heap allocation; other functors are heap-allocated.
+     * @param R return type.
+     * @param A argument types.
+     * @param Size size of the internal buffer, in bytes.
+     */
+    template <class R, class... A, size_t Size> class SmallFunction<R(A...), Size> {
+    public:
+        /**
+         * The default constructor.
+         * The function is empty.
+         */
+        SmallFunction() noexcept {
+        }
+
+        /**
+         * Constructor from nullptr.
+         * The function is empty.
+         */
+        SmallFunction(std::nullptr_t) noexcept {
+        }
+
+        /**
+         * Constructor from functor.
+         * @param func functor to store; if it is a function pointer or std::function, it must not be null.
+         */
+        template <class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, A...>>>
+        SmallFunction(F&& func) {
+            using T = std::decay_t<F>;
+            if constexpr (_isInPlace<T>()) {
+                new (m_buffer) T(std::forward<F>(func));
+                m_invoke = &_invokeInPlace<T>;
+                m_manage = &_manageInPlace<T>;
+            }
+            else {
+                *reinterpret_cast<T**>(m_buffer) = new T(std::forward<F>(func));
+                m_invoke = &_invokeAllocated<T>;
+                m_manage = &_manageAllocated<T>;
+            }
+        }
+
+        /**
+         * The copy constructor.
+         * Deleted because the function is move-only.
+         */
+        SmallFunction(const SmallFunction&) = delete;
+
+        /**
+         * The move constructor.
+         * @param func source object; it becomes empty.
+         */
+        SmallFunction(SmallFunction&& func) noexcept {
+            _moveFrom(func);
+        }
+
+        /**
+         * The destructor.
+         * Destroys the stored functor.
+         */
+        ~SmallFunction() {
+            _reset();
+        }
+
+        /**
+         * The copy assignment operator.
+         * Deleted because the function is move-only.
+         */
+        SmallFunction& operator = (const SmallFunction&) = delete;
+
+        /**
+         * The move assignment operator.
+         * @param func source object; it becomes empty.
+         * @return reference to this.
+         */
+        SmallFunction& operator = (SmallFunction&& func) noexcept {
+            if (&func != this) {
+                _reset();
+                _moveFrom(func);
+            }
+            return *this;
+        }
+
+        /**
+         * Assignment from nullptr.
+         * The function becomes empty.
+         * @return reference to this.
+         */
+        SmallFunction& operator = (std::nullptr_t) noexcept {
+            _reset();
+            return *this;
+        }
+
+        /**
+         * Checks if the function is not empty.
+         * @return true if the function is not empty, false otherwise.
+         */
+        explicit operator bool() const {
+            return m_invoke != nullptr;
+        }
+
+        /**
+         * Invokes the stored functor.
+         * @param args arguments.
+         * @return the result of the functor.
+         * @exception std::bad_function_call thrown if the function is empty.
+         */
+        R operator ()(A... args) const {
+            if (!m_invoke) {
+                throw std::bad_function_call();
+            }
+            return m_invoke(m_buffer, std::forward<A>(args)...);
+        }
+
+    private:
+        enum class Operation { Move, Destroy };
+
+        alignas(std::max_align_t) mutable unsigned char m_buffer[Size];
+        R (*m_invoke)(void*, A&&...){ nullptr };
+        void (*m_manage)(Operation, void*, void*){ nullptr };
+
+        template <class T> static constexpr bool _isInPlace() {
+            return sizeof(T) <= Size && alignof(std::max_align_t) % alignof(T) == 0 && std::is_nothrow_move_constructible_v<T>;
+        }
+
+        template <class T> static R _invokeInPlace(void* buffer, A&&... args) {
+            return (*reinterpret_cast<T*>(buffer))(std::forward<A>(args)...);
+        }
+
+        template <class T> static R _invokeAllocated(void* buffer, A&&... args) {
+            return (**reinterpret_cast<T**>(buffer))(std::forward<A>(args)...);
+        }
+
+        template <class T> static void _manageInPlace(Operation op, void* dst, void* src) {
+            switch (op) {
+                case Operation::Move:
+                    new (dst) T(std::move(*reinterpret_cast<T*>(src)));
+                    reinterpret_cast<T*>(src)->~T();
+                    break;
+
+                case Operation::Destroy:
+                    reinterpret_cast<T*>(dst)->~T();
+                    break;
+            }
+        }
+
+        template <class T> static void _manageAllocated(Operation op, void* dst, void* src) {
+            switch (op) {
+                case Operation::Move:
+                    *reinterpret_cast<T**>(dst) = *reinterpret_cast<T**>(src);
+                    break;
+
+                case Operation::Destroy:
+                    delete *reinterpret_cast<T**>(dst);
+                    break;
+            }
+        }
+
+        void _moveFrom(SmallFunction& func) noexcept {
+            if (func.m_invoke) {
+                func.m_manage(Operation::Move, m_buffer, func.m_buffer);
+                m_invoke = func.m_invoke;
+                m_manage = func.m_manage;
+                func.m_invoke = nullptr;
+                func.m_manage = nullptr;
+            }
+        }
+
+        void _reset() noexcept {
+            if (m_invoke) {
+                m_manage(Operation::Destroy, m_buffer, nullptr);
+                m_invoke = nullptr;
+                m_manage = nullptr;
+            }
+        }
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_SMALLFUNCTION_HPP
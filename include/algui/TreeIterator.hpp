@@ -0,0 +1,522 @@
+#ifndef ALGUI_TREEITERATOR_HPP
+#define ALGUI_TREEITERATOR_HPP
+
+
+#include <cstddef>
+#include <iterator>
+
+
+namespace algui {
+
+
+    /**
+     * Iterator over a subtree, in pre-order (i.e. parents before children).
+     * It uses no recursion and allocates nothing; it keeps only the current node and the root of the subtree.
+     * A default-constructed iterator is the end iterator.
+     * @param T type of node.
+     */
+    template <class T> class TreePreorderIterator {
+    public:
+        ///iterator category.
+        using iterator_category = std::forward_iterator_tag;
+
+        ///value type.
+        using value_type = T;
+
+        ///difference type.
+        using difference_type = std::ptrdiff_t;
+
+        ///pointer type.
+        using pointer = T*;
+
+        ///reference type.
+        using reference = T&;
+
+        /**
+         * The default constructor.
+         * It creates an end iterator.
+         */
+        TreePreorderIterator() {
+        }
+
+        /**
+         * Creates an iterator that starts from the given node.
+         * @param root root of the subtree to iterate; if null, the iterator is an end iterator.
+         */
+        explicit TreePreorderIterator(T* root) : m_node(root), m_root(root) {
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T& operator *() const {
+            return *m_node;
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T* operator ->() const {
+            return m_node;
+        }
+
+        /**
+         * Moves to the next node.
+         * @return reference to this.
+         */
+        TreePreorderIterator& operator ++() {
+            T* child = m_skipChildren ? nullptr : m_node->getFirstChildPtr();
+            m_skipChildren = false;
+            if (child) {
+                m_node = child;
+                return *this;
+            }
+
+            //if a node is removed from the tree while being visited, the iteration ends at its last ancestor
+            for (T* node = m_node; node && node != m_root; node = node->getParentPtr()) {
+                T* next = node->getNextSiblingPtr();
+                if (next) {
+                    m_node = next;
+                    return *this;
+                }
+            }
+            m_node = nullptr;
+            return *this;
+        }
+
+        /**
+         * Moves to the next node.
+         * @return copy of this before moving.
+         */
+        TreePreorderIterator operator ++(int) {
+            TreePreorderIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**
+         * Makes the next increment skip the children of the current node.
+         * It is the pruning hook of the iteration.
+         */
+        void skipChildren() {
+            m_skipChildren = true;
+        }
+
+        /**
+         * Checks if two iterators point to the same node.
+         * @param it the other iterator.
+         * @return true if the iterators point to the same node, false otherwise.
+         */
+        bool operator == (const TreePreorderIterator& it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         * Checks if two iterators point to different nodes.
+         * @param it the other iterator.
+         * @return true if the iterators point to different nodes, false otherwise.
+         */
+        bool operator != (const TreePreorderIterator& it) const {
+            return m_node != it.m_node;
+        }
+
+    private:
+        T* m_node{ nullptr };
+        T* m_root{ nullptr };
+        bool m_skipChildren{ false };
+    };
+
+
+    /**
+     * Iterator over a subtree, in post-order (i.e. children before parents).
+     * It uses no recursion and allocates nothing; it keeps only the current node and the root of the subtree.
+     * A default-constructed iterator is the end iterator.
+     * @param T type of node.
+     */
+    template <class T> class TreePostorderIterator {
+    public:
+        ///iterator category.
+        using iterator_category = std::forward_iterator_tag;
+
+        ///value type.
+        using value_type = T;
+
+        ///difference type.
+        using difference_type = std::ptrdiff_t;
+
+        ///pointer type.
+        using pointer = T*;
+
+        ///reference type.
+        using reference = T&;
+
+        /**
+         * The default constructor.
+         * It creates an end iterator.
+         */
+        TreePostorderIterator() {
+        }
+
+        /**
+         * Creates an iterator that starts from the first leaf of the given node.
+         * @param root root of the subtree to iterate; if null, the iterator is an end iterator.
+         */
+        explicit TreePostorderIterator(T* root) : m_node(root ? _getFirstLeaf(root) : nullptr), m_root(root) {
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T& operator *() const {
+            return *m_node;
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T* operator ->() const {
+            return m_node;
+        }
+
+        /**
+         * Moves to the next node.
+         * @return reference to this.
+         */
+        TreePostorderIterator& operator ++() {
+            if (m_node == m_root) {
+                m_node = nullptr;
+            }
+            else if (T* next = m_node->getNextSiblingPtr()) {
+                m_node = _getFirstLeaf(next);
+            }
+            else {
+                m_node = m_node->getParentPtr();
+            }
+            return *this;
+        }
+
+        /**
+         * Moves to the next node.
+         * @return copy of this before moving.
+         */
+        TreePostorderIterator operator ++(int) {
+            TreePostorderIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**
+         * Checks if two iterators point to the same node.
+         * @param it the other iterator.
+         * @return true if the iterators point to the same node, false otherwise.
+         */
+        bool operator == (const TreePostorderIterator& it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         * Checks if two iterators point to different nodes.
+         * @param it the other iterator.
+         * @return true if the iterators point to different nodes, false otherwise.
+         */
+        bool operator != (const TreePostorderIterator& it) const {
+            return m_node != it.m_node;
+        }
+
+    private:
+        T* m_node{ nullptr };
+        T* m_root{ nullptr };
+
+        static T* _getFirstLeaf(T* node) {
+            for (T* child = node->getFirstChildPtr(); child; child = child->getFirstChildPtr()) {
+                node = child;
+            }
+            return node;
+        }
+    };
+
+
+    /**
+     * Iterator over the ancestors of a node, from the parent up to the root.
+     * A default-constructed iterator is the end iterator.
+     * @param T type of node.
+     */
+    template <class T> class TreeAncestorIterator {
+    public:
+        ///iterator category.
+        using iterator_category = std::forward_iterator_tag;
+
+        ///value type.
+        using value_type = T;
+
+        ///difference type.
+        using difference_type = std::ptrdiff_t;
+
+        ///pointer type.
+        using pointer = T*;
+
+        ///reference type.
+        using reference = T&;
+
+        /**
+         * The default constructor.
+         * It creates an end iterator.
+         */
+        TreeAncestorIterator() {
+        }
+
+        /**
+         * Creates an iterator that starts from the given node.
+         * @param node first node of the iteration; if null, the iterator is an end iterator.
+         */
+        explicit TreeAncestorIterator(T* node) : m_node(node) {
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T& operator *() const {
+            return *m_node;
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T* operator ->() const {
+            return m_node;
+        }
+
+        /**
+         * Moves to the parent node.
+         * @return reference to this.
+         */
+        TreeAncestorIterator& operator ++() {
+            m_node = m_node->getParentPtr();
+            return *this;
+        }
+
+        /**
+         * Moves to the parent node.
+         * @return copy of this before moving.
+         */
+        TreeAncestorIterator operator ++(int) {
+            TreeAncestorIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**
+         * Checks if two iterators point to the same node.
+         * @param it the other iterator.
+         * @return true if the iterators point to the same node, false otherwise.
+         */
+        bool operator == (const TreeAncestorIterator& it) const {
+            return m_node == it.m_node;
+        }
+
+        /**
+         * Checks if two iterators point to different nodes.
+         * @param it the other iterator.
+         * @return true if the iterators point to different nodes, false otherwise.
+         */
+        bool operator != (const TreeAncestorIterator& it) const {
+            return m_node != it.m_node;
+        }
+
+    private:
+        T* m_node{ nullptr };
+    };
+
+
+    /**
+     * Iterator that visits each node of a subtree twice: when entering it, before its children,
+     * and when leaving it, after its children.
+     * It allows walks that need to do work both before and after the children of a node, e.g. painting,
+     * without recursion and without allocation.
+     * A default-constructed iterator is the end iterator.
+     * @param T type of node.
+     */
+    template <class T> class TreeTraversalIterator {
+    public:
+        ///iterator category.
+        using iterator_category = std::forward_iterator_tag;
+
+        ///value type.
+        using value_type = T;
+
+        ///difference type.
+        using difference_type = std::ptrdiff_t;
+
+        ///pointer type.
+        using pointer = T*;
+
+        ///reference type.
+        using reference = T&;
+
+        /**
+         * The default constructor.
+         * It creates an end iterator.
+         */
+        TreeTraversalIterator() {
+        }
+
+        /**
+         * Creates an iterator that starts by entering the given node.
+         * @param root root of the subtree to iterate; if null, the iterator is an end iterator.
+         */
+        explicit TreeTraversalIterator(T* root) : m_node(root), m_root(root) {
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T& operator *() const {
+            return *m_node;
+        }
+
+        /**
+         * Returns the current node.
+         * @return the current node.
+         */
+        T* operator ->() const {
+            return m_node;
+        }
+
+        /**
+         * Checks if the current node is entered, i.e. its children are not visited yet.
+         * @return true if the current node is entered, false if it is left.
+         */
+        bool isEntering() const {
+            return !m_leaving;
+        }
+
+        /**
+         * Checks if the current node is left, i.e. its children are already visited.
+         * @return true if the current node is left, false if it is entered.
+         */
+        bool isLeaving() const {
+            return m_leaving;
+        }
+
+        /**
+         * Moves to the next step of the traversal.
+         * @return reference to this.
+         */
+        TreeTraversalIterator& operator ++() {
+            if (!m_leaving) {
+                T* child = m_skipChildren ? nullptr : m_node->getFirstChildPtr();
+                m_skipChildren = false;
+                if (child) {
+                    m_node = child;
+                }
+                else {
+                    m_leaving = true;
+                }
+            }
+            else if (m_node == m_root) {
+                m_node = nullptr;
+                m_leaving = false;
+            }
+            else if (T* next = m_node->getNextSiblingPtr()) {
+                m_node = next;
+                m_leaving = false;
+            }
+            else {
+                m_node = m_node->getParentPtr();
+                m_leaving = m_node != nullptr;
+            }
+            return *this;
+        }
+
+        /**
+         * Moves to the next step of the traversal.
+         * @return copy of this before moving.
+         */
+        TreeTraversalIterator operator ++(int) {
+            TreeTraversalIterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        /**
+         * Makes the next increment skip the children of the current node, which is entered;
+         * the node is still left after that.
+         * It is the pruning hook of the traversal.
+         * It has no effect if the current node is left.
+         */
+        void skipChildren() {
+            m_skipChildren = !m_leaving;
+        }
+
+        /**
+         * Checks if two iterators are at the same step.
+         * @param it the other iterator.
+         * @return true if the iterators are at the same step, false otherwise.
+         */
+        bool operator == (const TreeTraversalIterator& it) const {
+            return m_node == it.m_node && m_leaving == it.m_leaving;
+        }
+
+        /**
+         * Checks if two iterators are at different steps.
+         * @param it the other iterator.
+         * @return true if the iterators are at different steps, false otherwise.
+         */
+        bool operator != (const TreeTraversalIterator& it) const {
+            return !(*this == it);
+        }
+
+    private:
+        T* m_node{ nullptr };
+        T* m_root{ nullptr };
+        bool m_leaving{ false };
+        bool m_skipChildren{ false };
+    };
+
+
+    /**
+     * A range of tree nodes, for use with range-based for loops and algorithms.
+     * The end of the range is a default-constructed iterator.
+     * @param I type of iterator.
+     */
+    template <class I> class TreeRange {
+    public:
+        /**
+         * The constructor.
+         * @param begin the first iterator.
+         */
+        explicit TreeRange(const I& begin) : m_begin(begin) {
+        }
+
+        /**
+         * Returns the first iterator.
+         * @return the first iterator.
+         */
+        I begin() const {
+            return m_begin;
+        }
+
+        /**
+         * Returns the end iterator.
+         * @return the end iterator.
+         */
+        I end() const {
+            return I();
+        }
+
+    private:
+        I m_begin;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_TREEITERATOR_HPP
@@ -0,0 +1,155 @@
+#ifndef ALGUI_TREELINKPOLICY_HPP
+#define ALGUI_TREELINKPOLICY_HPP
+
+
+#include <memory>
+#include <utility>
+
+
+namespace algui {
+
+
+    /**
+     * Tree link policy under which nodes own their next sibling and first child through shared pointers.
+     * Each owning link takes two pointers, and changing a link changes the reference count of the linked node atomically.
+     */
+    struct SharedTreeLinkPolicy {
+        /**
+         * Type of owning link.
+         * @param T type of node.
+         */
+        template <class T> using Link = std::shared_ptr<T>;
+
+        /**
+         * Base class of nodes; it is empty.
+         * @param T type of node.
+         */
+        template <class T> class NodeBase {
+        };
+
+        /**
+         * Returns the node of a link.
+         * @param link link.
+         * @return the node of the link.
+         */
+        template <class T> static T* get(const Link<T>& link) {
+            return link.get();
+        }
+
+        /**
+         * Returns the shared pointer that owns the node of a link.
+         * @param link link.
+         * @return the shared pointer that owns the node of the link; null if the link is null.
+         */
+        template <class T> static const std::shared_ptr<T>& getShared(const Link<T>& link) {
+            return link;
+        }
+
+        /**
+         * Creates the owning link of a node that is added to a tree.
+         * @param node node.
+         * @return the owning link of the node.
+         */
+        template <class T> static Link<T> attach(const std::shared_ptr<T>& node) {
+            return node;
+        }
+
+        /**
+         * Clears the owning link of a node that is removed from a tree.
+         * @param link the owning link of the node; it is reset.
+         * @return the ownership the tree had over the node.
+         */
+        template <class T> static std::shared_ptr<T> detach(Link<T>& link) {
+            return std::exchange(link, nullptr);
+        }
+    };
+
+
+    /**
+     * Tree link policy under which links are plain pointers, and a node is owned by the tree through a shared pointer to itself,
+     * from the moment it is added to a tree until the moment it is removed from it.
+     *
+     * Relinking siblings (e.g. when inserting, moving or removing nodes) only rewrites plain pointers,
+     * and does not touch any reference count; that is the only saving of this policy.
+     * It is not a non-atomic intrusive reference count: adding and removing a node still change its shared reference count atomically,
+     * and the self reference takes the two pointers that the owning link of the node takes under SharedTreeLinkPolicy,
+     * so nodes are as large as under that policy.
+     *
+     * The self reference is what keeps the shared pointer API of tree nodes available,
+     * since the getters return references to shared pointers.
+     */
+    struct IntrusiveTreeLinkPolicy {
+        /**
+         * Type of owning link.
+         * @param T type of node.
+         */
+        template <class T> using Link = T*;
+
+        /**
+         * Base class of nodes; it contains the self reference of a node.
+         * @param T type of node.
+         */
+        template <class T> class NodeBase {
+        private:
+            //set while the node is part of a tree
+            std::shared_ptr<T> m_self;
+
+            friend struct IntrusiveTreeLinkPolicy;
+        };
+
+        /**
+         * Returns the node of a link.
+         * @param link link.
+         * @return the node of the link.
+         */
+        template <class T> static T* get(const Link<T>& link) {
+            return link;
+        }
+
+        /**
+         * Returns the shared pointer that owns the node of a link.
+         * @param link link.
+         * @return the shared pointer that owns the node of the link; null if the link is null.
+         */
+        template <class T> static const std::shared_ptr<T>& getShared(const Link<T>& link) {
+            static const std::shared_ptr<T> null;
+            return link ? static_cast<const NodeBase<T>*>(link)->m_self : null;
+        }
+
+        /**
+         * Creates the owning link of a node that is added to a tree.
+         * @param node node.
+         * @return the owning link of the node.
+         */
+        template <class T> static Link<T> attach(const std::shared_ptr<T>& node) {
+            static_cast<NodeBase<T>*>(node.get())->m_self = node;
+            return node.get();
+        }
+
+        /**
+         * Clears the owning link of a node that is removed from a tree.
+         * @param link the owning link of the node; it is reset.
+         * @return the ownership the tree had over the node.
+         */
+        template <class T> static std::shared_ptr<T> detach(Link<T>& link) {
+            T* node = std::exchange(link, nullptr);
+            return node ? std::move(static_cast<NodeBase<T>*>(node)->m_self) : nullptr;
+        }
+    };
+
+
+    /**
+     * The tree link policy used by default.
+     * It is the intrusive policy if the macro `ALGUI_INTRUSIVE_TREE_LINKS` is defined, the shared pointer policy otherwise.
+     */
+#ifdef ALGUI_INTRUSIVE_TREE_LINKS
+    using DefaultTreeLinkPolicy = IntrusiveTreeLinkPolicy;
+#else
+    using DefaultTreeLinkPolicy = SharedTreeLinkPolicy;
+#endif
+
+
+} //namespace algui
+
+
+#endif //ALGUI_TREELINKPOLICY_HPP
@@ -4,8 +4,14 @@
 
 #include <stdexcept>
 #include <memory>
+#include <vector>
+#include <utility>
 #include "EventTarget.hpp"
 #include "ChildEvent.hpp"
+#include "ChildrenEvent.hpp"
+#include "TreeLinkPolicy.hpp"
+#include "ChildIndex.hpp"
+#include "TreeIterator.hpp"
 
 
 namespace algui {
@@ -14,15 +20,53 @@ namespace algui {
     /**
      * Base class for tree nodes.
      * @param T type of derived class.
+     * @param L link policy; see SharedTreeLinkPolicy and IntrusiveTreeLinkPolicy.
      */
-    template <class T> class TreeNode : public EventTarget {
+    template <class T, class L = DefaultTreeLinkPolicy> class TreeNode : public EventTarget, public L::template NodeBase<T>, private ChildIndex::Entry {
     public:
+        /**
+         * The destructor.
+         * Children are detached from this, and the ones not referenced elsewhere are destroyed;
+         * destruction is iterative, so that the stack depth does not depend on the number of siblings or on the depth of the tree.
+         */
+        virtual ~TreeNode() {
+            //children are queued and destroyed by the outermost destructor of the thread
+            static thread_local std::vector<std::shared_ptr<T>> pendingNodes;
+            static thread_local bool destroying = false;
+
+            m_childIndex.reset();
+            m_childCount = 0;
+            if (m_cachedAsRoot) {
+                _invalidateCachedPositions();
+            }
+            m_lastChild = nullptr;
+            for (std::shared_ptr<T> child = L::detach(m_firstChild); child; ) {
+                std::shared_ptr<T> next = L::detach(child->m_nextSibling);
+                child->m_parent = nullptr;
+                child->m_prevSibling = nullptr;
+                pendingNodes.push_back(std::move(child));
+                child = std::move(next);
+            }
+
+            if (destroying) {
+                return;
+            }
+
+            destroying = true;
+            while (!pendingNodes.empty()) {
+                std::shared_ptr<T> node = std::move(pendingNodes.back());
+                pendingNodes.pop_back();
+                node.reset();
+            }
+            destroying = false;
+        }
+
         /**
          * Returns a pointer to the parent node.
          * @return a pointer to the parent node.
          */
         std::shared_ptr<T> getParent() const {
-            return m_parent ? m_parent->sharedFromThis<T>() : nullptr;
+            return m_parent ? m_parent->template sharedFromThis<T>() : nullptr;
         }
 
         /**
@@ -30,7 +74,8 @@ namespace algui {
          * @return a pointer to the previous sibling node.
          */
         const std::shared_ptr<T>& getPrevSibling() const {
-            return m_prevSibling;
+            static const std::shared_ptr<T> null;
+            return m_prevSibling ? _getOwningPtr(m_prevSibling) : null;
         }
 
         /**
@@ -38,7 +83,7 @@ namespace algui {
          * @return a pointer to the next sibling node.
          */
         const std::shared_ptr<T>& getNextSibling() const {
-            return m_nextSibling;
+            return L::getShared(m_nextSibling);
         }
 
         /**
@@ -46,7 +91,7 @@ namespace algui {
          * @return a pointer to the first child node.
          */
         const std::shared_ptr<T>& getFirstChild() const {
-            return m_firstChild;
+            return L::getShared(m_firstChild);
         }
 
         /**
@@ -54,7 +99,90 @@ namespace algui {
          * @return a pointer to the last child node.
          */
         const std::shared_ptr<T>& getLastChild() const {
-            return m_lastChild;
+            static const std::shared_ptr<T> null;
+            return m_lastChild ? _getOwningPtr(m_lastChild) : null;
+        }
+
+        /**
+         * Returns the number of children.
+         * @return the number of children.
+         */
+        size_t getChildCount() const {
+            return m_childCount;
+        }
+
+        /**
+         * Returns the child at the given index.
+         * It takes logarithmic time if the child index is enabled, linear time otherwise.
+         * @param index index of child.
+         * @return the child at the given index.
+         * @exception std::out_of_range thrown if the index is not less than the number of children.
+         */
+        const std::shared_ptr<T>& getChildAt(size_t index) const {
+            if (index >= m_childCount) {
+                throw std::out_of_range("TreeNode: getChildAt: index out of range.");
+            }
+            return _getOwningPtr(_getChildPtrAt(index));
+        }
+
+        /**
+         * Returns the index of a child.
+         * It takes logarithmic time if the child index is enabled, linear time otherwise.
+         * @param child child; must be a child of this.
+         * @return the index of the child.
+         * @exception std::invalid_argument thrown if the given node is not a child of this.
+         */
+        size_t indexOf(const T* child) const {
+            if (!child || child->m_parent != this) {
+                throw std::invalid_argument("TreeNode: indexOf: not a child.");
+            }
+            if (m_childIndex) {
+                return m_childIndex->getIndex(child);
+            }
+            size_t result = 0;
+            for (const T* sibling = child->m_prevSibling; sibling; sibling = sibling->m_prevSibling) {
+                ++result;
+            }
+            return result;
+        }
+
+        /**
+         * Returns the index of a child.
+         * It takes logarithmic time if the child index is enabled, linear time otherwise.
+         * @param child child; must be a child of this.
+         * @return the index of the child.
+         * @exception std::invalid_argument thrown if the given node is not a child of this.
+         */
+        size_t indexOf(const std::shared_ptr<T>& child) const {
+            return indexOf(child.get());
+        }
+
+        /**
+         * Checks if the child index is enabled.
+         * The default is false.
+         * @return true if the child index is enabled, false otherwise.
+         */
+        bool isChildIndexEnabled() const {
+            return static_cast<bool>(m_childIndex);
+        }
+
+        /**
+         * Enables or disables the child index.
+         * The child index allows finding a child by index and the index of a child in logarithmic time,
+         * at the cost of a few pointers per child, and of keeping the index up to date when children are added or removed.
+         * It is meant for nodes with many children that are accessed by index, e.g. lists.
+         * @param v if true, the child index is created from the current children, otherwise it is destroyed.
+         */
+        void setChildIndexEnabled(bool v) {
+            if (!v) {
+                m_childIndex.reset();
+            }
+            else if (!m_childIndex) {
+                m_childIndex = std::make_unique<ChildIndex>();
+                for (T* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
+                    m_childIndex->insert(child);
+                }
+            }
         }
 
         /**
@@ -62,32 +190,38 @@ namespace algui {
          * @return a pointer to the root node.
          */
         std::shared_ptr<T> getRoot() const {
-            T* root = const_cast<T*>(static_cast<const T*>(this));
-            for (; root->m_parent; root = root->m_parent) {}
-            return root->sharedFromThis<T>();
+            return getRootPtr()->template sharedFromThis<T>();
         }
 
         /**
          * Returns a raw pointer to the root node.
+         * It is cached, like the depth.
          * @return a raw pointer to the root node.
          */
         T* getRootPtr() const {
-            T* root = const_cast<T*>(static_cast<const T*>(this));
-            for (; root->m_parent; root = root->m_parent) {}
-            return root;
+            _updateCachedPosition();
+            return m_cachedRoot;
         }
 
         /**
          * Checks if the given node is part of this tree.
+         * Nodes not deeper than this are rejected without walking the tree;
+         * otherwise, only the depth difference is climbed.
          * @return true if the given node is part of this tree, false otherwise.
          */
         bool contains(const T* node) const {
-            for (; node; node = node->m_parent) {
-                if (node == this) {
-                    return true;
-                }
+            if (!node) {
+                return false;
+            }
+            const size_t depth = getDepth();
+            const size_t nodeDepth = node->getDepth();
+            if (nodeDepth < depth || node->getRootPtr() != getRootPtr()) {
+                return false;
             }
-            return false;
+            for (size_t i = nodeDepth - depth; i > 0; --i) {
+                node = node->m_parent;
+            }
+            return node == this;
         }
 
         /**
@@ -100,15 +234,14 @@ namespace algui {
 
         /**
          * Returns the depth of the node.
+         * The depth and the root are cached.
+         * When nodes are added or removed, the positions cached in the affected trees are invalidated without walking them,
+         * and recomputed lazily, by walking up to the nearest ancestor with a valid cache.
          * @return the depth of the node.
          */
         size_t getDepth() const {
-            size_t result = 0;
-            for (const TreeNode<T>* node = this; node->m_parent; node = node->m_parent) {
-                ++result;
-            }
-            return result;
-
+            _updateCachedPosition();
+            return m_cachedDepth;
         }
 
         /**
@@ -127,7 +260,8 @@ namespace algui {
                 throw std::invalid_argument("TreeNode: addChild: child already has a parent.");
             }
 
-            if (child->contains(static_cast<T*>(this))) {
+            //the only ancestor a parentless node can be is the root
+            if (child.get() == getRootPtr()) {
                 throw std::invalid_argument("TreeNode: addChild: child contains this.");
             }
 
@@ -135,18 +269,25 @@ namespace algui {
                 throw std::invalid_argument("TreeNode: addChild: nextSibling is not a child of this.");
             }
 
-            std::shared_ptr<T> prevSibling = nextSibling ? nextSibling->m_prevSibling : m_lastChild;
+            //nextSibling might refer to the link that is replaced below
+            T* next = nextSibling.get();
+            T* prevSibling = next ? next->m_prevSibling : m_lastChild;
+            Link& link = prevSibling ? prevSibling->m_nextSibling : m_firstChild;
 
             child->m_parent = static_cast<T*>(this);
             child->m_prevSibling = prevSibling;
-            child->m_nextSibling = nextSibling;
-
-            (prevSibling ? prevSibling->m_nextSibling : m_firstChild) = child;
-            (nextSibling ? nextSibling->m_prevSibling : m_lastChild) = child;
+            child->m_nextSibling = std::exchange(link, L::attach(child));
+            (next ? next->m_prevSibling : m_lastChild) = child.get();
+            ++m_childCount;
+            if (m_childIndex) {
+                m_childIndex->insert(child.get(), next);
+            }
+            _setAddedCachedPosition(child.get());
 
             setNewChildState(child);
 
-            dispatchEvent(ChildEvent<T>("childAdded", sharedFromThis<T>(), child));
+            static const EventType childAddedEventType("childAdded");
+            dispatchEvent(childAddedEventType, [&]() { return ChildEvent<T>(childAddedEventType, sharedFromThis<T>(), child); });
         }
 
         /**
@@ -164,20 +305,212 @@ namespace algui {
                 throw std::invalid_argument("TreeNode: removeChild: not a child.");
             }
 
-            remove(child);
+            //child might refer to a link of this
+            const std::shared_ptr<T> removedChild = child;
+
+            remove(removedChild);
+            setRemovedChildState(removedChild);
 
-            dispatchEvent(ChildEvent<T>("childRemoved", sharedFromThis<T>(), child));
+            static const EventType childRemovedEventType("childRemoved");
+            dispatchEvent(childRemovedEventType, [&]() { return ChildEvent<T>(childRemovedEventType, sharedFromThis<T>(), removedChild); });
         }
 
         /**
-         * Removes all children.
-         * It emits an ObjectEvent with type "childrenRemoved".
+         * Adds many child nodes at once.
+         * The constraints are checked once for all children, and the children are spliced in as one run;
+         * `setNewChildState()` is invoked for each child.
+         * It emits one ChildrenEvent with type "childrenAdded".
+         * @param children children to add, in order; they must not be null, must not already be children, must not be ancestors of this, must not repeat.
+         * @param nextSibling optional; if not given, then the children are added as last children, otherwise they are added before this; must be a child of this.
+         * @exception std::invalid_argument thrown if the constraints mentioned above are violated; no child is added then.
+         */
+        virtual void addChildren(const std::vector<std::shared_ptr<T>>& children, const std::shared_ptr<T>& nextSibling = nullptr) {
+            if (nextSibling && nextSibling->m_parent != this) {
+                throw std::invalid_argument("TreeNode: addChildren: nextSibling is not a child of this.");
+            }
+
+            //the only ancestor a parentless node can be is the root;
+            //children are marked with their new parent in order to find repeated ones, and unmarked if a check fails
+            T* root = getRootPtr();
+            for (auto it = children.begin(); it != children.end(); ++it) {
+                const char* error =
+                    !*it ? "TreeNode: addChildren: child is null." :
+                    (*it)->m_parent ? "TreeNode: addChildren: child already has a parent." :
+                    it->get() == root ? "TreeNode: addChildren: child contains this." :
+                    nullptr;
+                if (error) {
+                    for (auto marked = children.begin(); marked != it; ++marked) {
+                        (*marked)->m_parent = nullptr;
+                    }
+                    throw std::invalid_argument(error);
+                }
+                (*it)->m_parent = static_cast<T*>(this);
+            }
+
+            if (children.empty()) {
+                return;
+            }
+
+            //nextSibling might refer to the link that is replaced below
+            T* next = nextSibling.get();
+            T* prevSibling = next ? next->m_prevSibling : m_lastChild;
+            Link nextLink = std::exchange(prevSibling ? prevSibling->m_nextSibling : m_firstChild, nullptr);
+
+            for (const std::shared_ptr<T>& child : children) {
+                child->m_prevSibling = prevSibling;
+                (prevSibling ? prevSibling->m_nextSibling : m_firstChild) = L::attach(child);
+                prevSibling = child.get();
+            }
+            prevSibling->m_nextSibling = std::move(nextLink);
+            (next ? next->m_prevSibling : m_lastChild) = prevSibling;
+
+            m_childCount += children.size();
+            if (m_childIndex) {
+                for (const std::shared_ptr<T>& child : children) {
+                    m_childIndex->insert(child.get(), next);
+                }
+            }
+            for (const std::shared_ptr<T>& child : children) {
+                _setAddedCachedPosition(child.get());
+            }
+
+            for (const std::shared_ptr<T>& child : children) {
+                setNewChildState(child);
+            }
+
+            static const EventType childrenAddedEventType("childrenAdded");
+            dispatchEvent(childrenAddedEventType, [&]() { return ChildrenEvent<T>(childrenAddedEventType, sharedFromThis<T>(), children); });
+        }
+
+        /**
+         * Moves a child to another position among its siblings, without removing it from this.
+         * Unlike removing and adding the child, only `setMovedChildState()` is invoked, since the child's inherited state does not change.
+         * It emits a ChildEvent with type "childMoved", unless the child is already in the requested position.
+         * @param child child to move; must not be null, must be a child of this.
+         * @param nextSibling optional; if not given, then the child becomes the last child, otherwise it is moved before this; must be a child of this.
+         * @exception std::invalid_argument thrown if the constraints mentioned above are violated.
+         */
+        virtual void moveChild(const std::shared_ptr<T>& child, const std::shared_ptr<T>& nextSibling = nullptr) {
+            if (!child) {
+                throw std::invalid_argument("TreeNode: moveChild: child is null.");
+            }
+
+            if (child->m_parent != this) {
+                throw std::invalid_argument("TreeNode: moveChild: not a child.");
+            }
+
+            if (nextSibling && nextSibling->m_parent != this) {
+                throw std::invalid_argument("TreeNode: moveChild: nextSibling is not a child of this.");
+            }
+
+            //child and nextSibling might refer to links that are replaced below
+            const std::shared_ptr<T> movedChild = child;
+            T* node = movedChild.get();
+            T* next = nextSibling.get();
+            if (next == node || L::get(node->m_nextSibling) == next) {
+                return;
+            }
+
+            //unlink the child, keeping its owning link
+            T* oldPrevSibling = node->m_prevSibling;
+            T* oldNextSibling = L::get(node->m_nextSibling);
+            Link owningLink = std::exchange(oldPrevSibling ? oldPrevSibling->m_nextSibling : m_firstChild, std::exchange(node->m_nextSibling, nullptr));
+            (oldNextSibling ? oldNextSibling->m_prevSibling : m_lastChild) = oldPrevSibling;
+
+            //link the child before the next sibling
+            T* prevSibling = next ? next->m_prevSibling : m_lastChild;
+            node->m_nextSibling = std::exchange(prevSibling ? prevSibling->m_nextSibling : m_firstChild, std::move(owningLink));
+            node->m_prevSibling = prevSibling;
+            (next ? next->m_prevSibling : m_lastChild) = node;
+
+            if (m_childIndex) {
+                m_childIndex->erase(node);
+                m_childIndex->insert(node, next);
+            }
+
+            setMovedChildState(movedChild);
+
+            static const EventType childMovedEventType("childMoved");
+            dispatchEvent(childMovedEventType, [&]() { return ChildEvent<T>(childMovedEventType, sharedFromThis<T>(), movedChild); });
+        }
+
+        /**
+         * Moves this node after its siblings, i.e. in front of them when painting.
+         * It does nothing if this node has no parent.
+         */
+        void bringToFront() {
+            if (m_parent) {
+                m_parent->moveChild(_getOwningPtr(_getThis()));
+            }
+        }
+
+        /**
+         * Moves this node before its siblings, i.e. behind them when painting.
+         * It does nothing if this node has no parent.
+         */
+        void sendToBack() {
+            if (m_parent) {
+                m_parent->moveChild(_getOwningPtr(_getThis()), m_parent->getFirstChild());
+            }
+        }
+
+        /**
+         * Removes many child nodes at once.
+         * `setRemovedChildState()` is invoked for each child.
+         * It emits one ChildrenEvent with type "childrenRemoved".
+         * @param children children to remove; they must not be null, must be children of this; repeated children are removed once.
+         * @exception std::invalid_argument thrown if the constraints mentioned above are violated; no child is removed then.
+         */
+        virtual void removeChildren(const std::vector<std::shared_ptr<T>>& children) {
+            for (const std::shared_ptr<T>& child : children) {
+                if (!child || child->m_parent != this) {
+                    throw std::invalid_argument("TreeNode: removeChildren: not a child.");
+                }
+            }
+
+            //the given vector keeps the children alive
+            for (const std::shared_ptr<T>& child : children) {
+                if (child->m_parent == this) {
+                    remove(child);
+                    setRemovedChildState(child);
+                }
+            }
+
+            static const EventType childrenRemovedEventType("childrenRemoved");
+            dispatchEvent(childrenRemovedEventType, [&]() { return ChildrenEvent<T>(childrenRemovedEventType, sharedFromThis<T>(), children); });
+        }
+
+        /**
+         * Removes all children, in one pass.
+         * It emits one ChildrenEvent with type "childrenRemoved";
+         * the removed children are collected for the event only if there are listeners for it.
          */
         virtual void removeChildren() {
-            while (m_lastChild) {
-                remove(m_lastChild);
+            static const EventType childrenRemovedEventType("childrenRemoved");
+            const bool collectChildren = hasEventListeners(childrenRemovedEventType);
+            std::vector<std::shared_ptr<T>> removedChildren;
+
+            if (m_childIndex) {
+                m_childIndex->clear();
+            }
+            m_childCount = 0;
+            m_lastChild = nullptr;
+            if (m_firstChild) {
+                _invalidateTreeCachedPositions();
             }
-            dispatchEvent(ObjectEvent<T>("childrenRemoved", sharedFromThis<T>()));
+            for (std::shared_ptr<T> child = L::detach(m_firstChild); child; ) {
+                std::shared_ptr<T> next = L::detach(child->m_nextSibling);
+                child->m_parent = nullptr;
+                child->m_prevSibling = nullptr;
+                _setCachedPosition(child.get(), child.get(), 0);
+                setRemovedChildState(child);
+                if (collectChildren) {
+                    removedChildren.push_back(std::move(child));
+                }
+                child = std::move(next);
+            }
+
+            dispatchEvent(childrenRemovedEventType, [&]() { return ChildrenEvent<T>(childrenRemovedEventType, sharedFromThis<T>(), std::move(removedChildren)); });
         }
 
         /**
@@ -193,7 +526,7 @@ namespace algui {
          * @return a plain pointer to the previous sibling node.
          */
         T* getPrevSiblingPtr() const {
-            return m_prevSibling.get();
+            return m_prevSibling;
         }
 
         /**
@@ -201,7 +534,7 @@ namespace algui {
          * @return a plain pointer to the next sibling node.
          */
         T* getNextSiblingPtr() const {
-            return m_nextSibling.get();
+            return L::get(m_nextSibling);
         }
 
         /**
@@ -209,7 +542,7 @@ namespace algui {
          * @return a plain pointer to the first child node.
          */
         T* getFirstChildPtr() const {
-            return m_firstChild.get();
+            return L::get(m_firstChild);
         }
 
         /**
@@ -217,7 +550,40 @@ namespace algui {
          * @return a plain pointer to the last child node.
          */
         T* getLastChildPtr() const {
-            return m_lastChild.get();
+            return m_lastChild;
+        }
+
+        /**
+         * Returns the nodes of this tree in pre-order, starting from this.
+         * In order to skip the children of a node, iterate explicitly and call `skipChildren()` on the iterator.
+         * @return the nodes of this tree in pre-order.
+         */
+        TreeRange<TreePreorderIterator<T>> getPreorderRange() const {
+            return TreeRange<TreePreorderIterator<T>>(TreePreorderIterator<T>(_getThis()));
+        }
+
+        /**
+         * Returns the nodes of this tree in post-order, ending with this.
+         * @return the nodes of this tree in post-order.
+         */
+        TreeRange<TreePostorderIterator<T>> getPostorderRange() const {
+            return TreeRange<TreePostorderIterator<T>>(TreePostorderIterator<T>(_getThis()));
+        }
+
+        /**
+         * Returns the ancestors of this, from the parent up to the root.
+         * @return the ancestors of this.
+         */
+        TreeRange<TreeAncestorIterator<T>> getAncestorRange() const {
+            return TreeRange<TreeAncestorIterator<T>>(TreeAncestorIterator<T>(m_parent));
+        }
+
+        /**
+         * Returns the steps of a traversal of this tree, where each node is entered before its children and left after them.
+         * @return the steps of a traversal of this tree.
+         */
+        TreeRange<TreeTraversalIterator<T>> getTraversalRange() const {
+            return TreeRange<TreeTraversalIterator<T>>(TreeTraversalIterator<T>(_getThis()));
         }
 
     protected:
@@ -230,20 +596,163 @@ namespace algui {
         virtual void setNewChildState(const std::shared_ptr<T>& child) {
         }
 
+        /**
+         * Invoked when a child is removed.
+         * It allows updating the state of this after a child is removed.
+         * By default, it does nothing.
+         * @param child the removed child.
+         */
+        virtual void setRemovedChildState(const std::shared_ptr<T>& child) {
+        }
+
+        /**
+         * Invoked when a child is moved to another position among its siblings.
+         * It allows updating the state that depends on the order of children.
+         * By default, it does nothing.
+         * @param child the moved child.
+         */
+        virtual void setMovedChildState(const std::shared_ptr<T>& child) {
+        }
+
     private:
+        using Link = typename L::template Link<T>;
+
+        //siblings are owned through next sibling links only, in order to avoid reference cycles
         T* m_parent{ nullptr };
-        std::shared_ptr<T> m_prevSibling;
-        std::shared_ptr<T> m_nextSibling;
-        std::shared_ptr<T> m_firstChild;
-        std::shared_ptr<T> m_lastChild;
+        T* m_prevSibling{ nullptr };
+        Link m_nextSibling{};
+        Link m_firstChild{};
+        T* m_lastChild{ nullptr };
+        size_t m_childCount{ 0 };
+        std::unique_ptr<ChildIndex> m_childIndex;
+
+        /*
+            Depth and root.
+            A cached position is valid if it was cached in the current generation, its root is still a root,
+            and the root has the version it had when the position was cached.
+            The version of a node changes when it is added to a parent, and, while it is a root, when a node is removed from its tree;
+            so, while the version is unchanged, the path from the node up to its root is unchanged.
+            Destroying a node that is the cached root of other nodes starts a new generation,
+            so that valid positions never refer to destroyed roots.
+         */
+        mutable size_t m_cachedDepth{ 0 };
+        mutable T* m_cachedRoot{ nullptr };
+        mutable size_t m_cacheGeneration{ 0 };
+        mutable size_t m_cachedRootVersion{ 0 };
+        size_t m_rootVersion{ 0 };
+        mutable bool m_cachedAsRoot{ false };
+
+        static size_t& _getCacheGeneration() {
+            static size_t generation = 1;
+            return generation;
+        }
+
+        static void _invalidateCachedPositions() {
+            ++_getCacheGeneration();
+        }
+
+        static size_t _getNextRootVersion() {
+            static size_t version = 0;
+            return ++version;
+        }
+
+        bool _isCachedPositionValid(size_t generation) const {
+            return m_cacheGeneration == generation && m_cachedRootVersion == m_cachedRoot->m_rootVersion && !m_cachedRoot->m_parent;
+        }
+
+        static void _setCachedPosition(const TreeNode* node, T* root, size_t depth) {
+            node->m_cachedDepth = depth;
+            node->m_cachedRoot = root;
+            node->m_cacheGeneration = _getCacheGeneration();
+            node->m_cachedRootVersion = root->m_rootVersion;
+            if (node != root) {
+                root->m_cachedAsRoot = true;
+            }
+        }
+
+        //a node added to a parent gets its position from the parent; the positions cached under it while it was a root
+        //are invalidated by its new version, and recomputed lazily
+        static void _setAddedCachedPosition(T* node) {
+            node->m_rootVersion = _getNextRootVersion();
+            T* const root = node->m_parent->getRootPtr();
+            _setCachedPosition(node, root, node->m_parent->m_cachedDepth + 1);
+        }
+
+        //invoked when children of this are removed; the positions cached in the tree, including the ones in the removed subtrees,
+        //are invalidated by a new version of the root, and recomputed lazily
+        void _invalidateTreeCachedPositions() {
+            getRootPtr()->m_rootVersion = _getNextRootVersion();
+        }
+
+        //walks up to the nearest node with a valid cache, then caches the position of the nodes in between
+        void _updateCachedPosition() const {
+            const size_t generation = _getCacheGeneration();
+            if (_isCachedPositionValid(generation)) {
+                return;
+            }
+
+            const TreeNode* top = this;
+            size_t distance = 0;
+            for (; !top->_isCachedPositionValid(generation) && top->m_parent; top = top->m_parent) {
+                ++distance;
+            }
+            if (!top->_isCachedPositionValid(generation)) {
+                _setCachedPosition(top, top->_getThis(), 0);
+            }
+
+            size_t depth = top->m_cachedDepth + distance;
+            for (const TreeNode* node = this; node != top; node = node->m_parent, --depth) {
+                _setCachedPosition(node, top->m_cachedRoot, depth);
+            }
+        }
+
+        //returns the pointer that owns the given child node
+        static const std::shared_ptr<T>& _getOwningPtr(T* child) {
+            return L::getShared(child->m_prevSibling ? child->m_prevSibling->m_nextSibling : child->m_parent->m_firstChild);
+        }
+
+        T* _getThis() const {
+            return const_cast<T*>(static_cast<const T*>(this));
+        }
+
+        T* _getChildPtrAt(size_t index) const {
+            if (m_childIndex) {
+                return static_cast<T*>(static_cast<TreeNode*>(m_childIndex->getEntry(index)));
+            }
+
+            //walk from the nearest end
+            T* child;
+            if (index < m_childCount / 2) {
+                for (child = getFirstChildPtr(); index > 0; --index) {
+                    child = L::get(child->m_nextSibling);
+                }
+            }
+            else {
+                for (child = m_lastChild, index = m_childCount - 1 - index; index > 0; --index) {
+                    child = child->m_prevSibling;
+                }
+            }
+            return child;
+        }
 
         void remove(const std::shared_ptr<T>& child) {
-            (child->m_prevSibling ? child->m_prevSibling->m_nextSibling : m_firstChild) = child->m_nextSibling;
-            (child->m_nextSibling ? child->m_nextSibling->m_prevSibling : m_lastChild) = child->m_prevSibling;
+            if (m_childIndex) {
+                m_childIndex->erase(child.get());
+            }
+            --m_childCount;
+
+            T* next = L::get(child->m_nextSibling);
+            (next ? next->m_prevSibling : m_lastChild) = child->m_prevSibling;
+
+            //the caller keeps the child alive
+            Link& link = child->m_prevSibling ? child->m_prevSibling->m_nextSibling : m_firstChild;
+            L::detach(link);
+            link = std::exchange(child->m_nextSibling, nullptr);
 
             child->m_parent = nullptr;
-            child->m_prevSibling.reset();
-            child->m_nextSibling.reset();
+            child->m_prevSibling = nullptr;
+            _invalidateTreeCachedPositions();
+            _setCachedPosition(child.get(), child.get(), 0);
         }
     };
 
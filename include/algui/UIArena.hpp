@@ -0,0 +1,192 @@
+#ifndef ALGUI_UIARENA_HPP
+#define ALGUI_UIARENA_HPP
+
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+
+namespace algui {
+
+
+    /**
+     * An arena for allocating UI nodes (or any other shared objects).
+     *
+     * Objects are allocated with `make()`, which works like `std::make_shared`,
+     * but places the objects (along with their shared pointer control blocks) contiguously into large memory blocks,
+     * in creation order.
+     *
+     * The memory of destroyed objects is reused by later objects of the same size;
+     * the blocks are released all at once, when the arena is destroyed.
+     * Therefore, an arena is meant for trees that are built and torn down as a whole, e.g. a screen.
+     *
+     * Shared and weak pointers to objects of the arena may outlive it; the arena counts its live allocations with a plain counter,
+     * and if any are left when the arena is destroyed, the blocks are released when the last of them is deallocated.
+     *
+     * An arena shall be used from one thread only.
+     */
+    class UIArena {
+    public:
+        /**
+         * The default block size, in bytes.
+         */
+        static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+        /**
+         * Allocator that allocates from an arena.
+         * Deallocated memory is kept by the arena for reuse.
+         * @param T type of object to allocate.
+         */
+        template <class T> class Allocator;
+
+        /**
+         * The constructor.
+         * @param blockSize size of each memory block; allocations larger than that get a block of their own.
+         */
+        explicit UIArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+        /**
+         * The destructor.
+         * The memory blocks are released now, or after the last allocation is deallocated.
+         */
+        ~UIArena();
+
+        /**
+         * The copy constructor.
+         * Deleted because the arena is not copyable.
+         */
+        UIArena(const UIArena&) = delete;
+
+        /**
+         * The copy assignment operator.
+         * Deleted because the arena is not copyable.
+         */
+        UIArena& operator = (const UIArena&) = delete;
+
+        /**
+         * Creates a shared object in this arena.
+         * @param T type of object.
+         * @param args arguments to the object's constructor.
+         * @return a shared pointer to the object.
+         */
+        template <class T, class... A> std::shared_ptr<T> make(A&&... args) {
+            return std::allocate_shared<T>(Allocator<T>(m_storage), std::forward<A>(args)...);
+        }
+
+        /**
+         * Returns the number of bytes allocated from this arena and not yet deallocated.
+         * @return the number of bytes allocated from this arena and not yet deallocated.
+         */
+        size_t getAllocatedSize() const;
+
+        /**
+         * Returns the number of memory blocks of this arena.
+         * @return the number of memory blocks of this arena.
+         */
+        size_t getBlockCount() const;
+
+    private:
+        class Storage {
+        public:
+            Storage(size_t blockSize);
+            void* allocate(size_t size, size_t alignment);
+            void deallocate(void* p, size_t size);
+            size_t getAllocatedSize() const;
+            size_t getBlockCount() const;
+            void release();
+
+        private:
+            //freed memory, by size; each free entry points to the next one of the same size
+            struct FreeEntry {
+                FreeEntry* next;
+            };
+
+            std::vector<std::unique_ptr<unsigned char[]>> m_blocks;
+            std::unordered_map<size_t, FreeEntry*> m_freeLists;
+            size_t m_blockSize;
+            unsigned char* m_current{ nullptr };
+            size_t m_remaining{ 0 };
+            size_t m_allocatedSize{ 0 };
+            size_t m_allocationCount{ 0 };
+            bool m_released{ false };
+        };
+
+        //owned by the arena while it exists, then by its remaining allocations
+        Storage* m_storage;
+    };
+
+
+    template <class T> class UIArena::Allocator {
+    public:
+        ///allocated type.
+        using value_type = T;
+
+        /**
+         * Constructor from arena.
+         * @param arena arena to allocate from.
+         */
+        Allocator(UIArena& arena) : m_storage(arena.m_storage) {
+        }
+
+        /**
+         * Constructor from allocator of another type.
+         * @param allocator source allocator.
+         */
+        template <class U> Allocator(const Allocator<U>& allocator) : m_storage(allocator.m_storage) {
+        }
+
+        /**
+         * Allocates memory.
+         * @param count number of objects.
+         * @return pointer to the allocated memory.
+         */
+        T* allocate(size_t count) {
+            return static_cast<T*>(m_storage->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * Returns memory to the arena, for reuse by later allocations of the same size.
+         * @param p pointer to the memory.
+         * @param count number of objects.
+         */
+        void deallocate(T* p, size_t count) {
+            m_storage->deallocate(p, count * sizeof(T));
+        }
+
+        /**
+         * Checks if two allocators allocate from the same arena.
+         * @param allocator the other allocator.
+         * @return true if both allocators allocate from the same arena, false otherwise.
+         */
+        template <class U> bool operator == (const Allocator<U>& allocator) const {
+            return m_storage == allocator.m_storage;
+        }
+
+        /**
+         * Checks if two allocators allocate from different arenas.
+         * @param allocator the other allocator.
+         * @return true if the allocators allocate from different arenas, false otherwise.
+         */
+        template <class U> bool operator != (const Allocator<U>& allocator) const {
+            return m_storage != allocator.m_storage;
+        }
+
+    private:
+        //kept alive by the allocations made from it
+        Storage* m_storage;
+
+        Allocator(Storage* storage) : m_storage(storage) {
+        }
+
+        template <class U> friend class Allocator;
+        friend class UIArena;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_UIARENA_HPP
@@ -0,0 +1,157 @@
+#ifndef ALGUI_UICOMMANDBUFFER_HPP
+#define ALGUI_UICOMMANDBUFFER_HPP
+
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include "UINode.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * A buffer of UI tree mutations.
+     *
+     * Mutations are recorded in any thread, then applied in the UI thread, all at once, by `apply()`,
+     * usually through a UICommandQueue. A background thread can create nodes and record how to assemble them into a subtree
+     * and where to attach it, but all the recorded mutations run in the UI thread,
+     * including the ones that assemble a detached subtree.
+     * Consecutive additions of children to the same position are applied as one batch, via `addChildren()`.
+     *
+     * A buffer must be recorded by one thread at a time.
+     * Recording does not access the nodes, apart from holding references to them;
+     * the nodes must not be accessed in any other way outside of the UI thread,
+     * and the last references to nodes of a UI tree must be released in the UI thread.
+     */
+    class UICommandBuffer {
+    public:
+        /**
+         * The default constructor.
+         * The buffer is empty.
+         */
+        UICommandBuffer();
+
+        /**
+         * The move constructor.
+         * @param buffer the source buffer; it is left empty.
+         */
+        UICommandBuffer(UICommandBuffer&& buffer) = default;
+
+        /**
+         * The copy constructor.
+         * Deleted because commands are meant to be applied once.
+         */
+        UICommandBuffer(const UICommandBuffer&) = delete;
+
+        /**
+         * The move assignment operator.
+         * @param buffer the source buffer; it is left empty.
+         * @return reference to this.
+         */
+        UICommandBuffer& operator = (UICommandBuffer&& buffer) = default;
+
+        /**
+         * The copy assignment operator.
+         * Deleted because commands are meant to be applied once.
+         */
+        UICommandBuffer& operator = (const UICommandBuffer&) = delete;
+
+        /**
+         * Creates a node in the calling thread.
+         * The node belongs to no tree, until a recorded `addChild()` command that adds it is applied.
+         * @param args arguments to the node constructor.
+         * @return the new node.
+         */
+        template <class T = UINode, class... A> std::shared_ptr<T> createNode(A&&... args) {
+            return std::make_shared<T>(std::forward<A>(args)...);
+        }
+
+        /**
+         * Records the addition of a child.
+         * @param parent the parent node; must not be null.
+         * @param child the child to add; must not be null.
+         * @param nextSibling the next sibling of the child; if null, the child is appended.
+         * @exception std::invalid_argument thrown if the parent or the child is null.
+         */
+        void addChild(std::shared_ptr<UINode> parent, std::shared_ptr<UINode> child, std::shared_ptr<UINode> nextSibling = nullptr);
+
+        /**
+         * Records the removal of a node from its parent.
+         * When the command is applied, nodes without a parent are left as is.
+         * @param node the node to remove; must not be null.
+         * @exception std::invalid_argument thrown if the node is null.
+         */
+        void remove(std::shared_ptr<UINode> node);
+
+        /**
+         * Records the change of the rectangle of a node.
+         * @param node the node; must not be null.
+         * @param rect the new rectangle.
+         * @exception std::invalid_argument thrown if the node is null.
+         */
+        void setRect(std::shared_ptr<UINode> node, const Rect& rect);
+
+        /**
+         * Records the change of the visible state of a node.
+         * @param node the node; must not be null.
+         * @param v the new visible state.
+         * @exception std::invalid_argument thrown if the node is null.
+         */
+        void setVisible(std::shared_ptr<UINode> node, bool v);
+
+        /**
+         * Returns the number of recorded commands.
+         * @return the number of recorded commands.
+         */
+        size_t getCommandCount() const {
+            return m_commands.size();
+        }
+
+        /**
+         * Checks if the buffer is empty.
+         * @return true if there are no recorded commands, false otherwise.
+         */
+        bool isEmpty() const {
+            return m_commands.empty();
+        }
+
+        /**
+         * Discards the recorded commands.
+         */
+        void clear();
+
+        /**
+         * Applies the recorded commands, in the order they were recorded, then empties the buffer.
+         * It must be called from the UI thread only.
+         * If a command throws an exception, the commands applied before it are not undone,
+         * the rest of the commands are discarded, and the exception is propagated.
+         */
+        void apply();
+
+    private:
+        enum class CommandType {
+            ADD_CHILD,
+            REMOVE,
+            SET_RECT,
+            SET_VISIBLE
+        };
+
+        struct Command {
+            CommandType type;
+            std::shared_ptr<UINode> node;
+            std::shared_ptr<UINode> child;
+            std::shared_ptr<UINode> nextSibling;
+            Rect rect;
+            bool visible;
+        };
+
+        std::vector<Command> m_commands;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_UICOMMANDBUFFER_HPP
@@ -0,0 +1,63 @@
+#ifndef ALGUI_UICOMMANDQUEUE_HPP
+#define ALGUI_UICOMMANDQUEUE_HPP
+
+
+#include <mutex>
+#include <vector>
+#include "UICommandBuffer.hpp"
+
+
+namespace algui {
+
+
+    /**
+     * A queue of UI command buffers submitted from any thread, to be applied in the UI thread.
+     *
+     * Buffers are applied at frame boundaries, in the order they were submitted, and the commands of a buffer are applied
+     * one after the other, without painting in between; therefore, a frame shows either none or all of the mutations of a buffer,
+     * unless a command throws an exception, in which case the commands applied before it are not undone.
+     */
+    class UICommandQueue {
+    public:
+        /**
+         * The default constructor.
+         */
+        UICommandQueue();
+
+        /**
+         * The copy constructor.
+         * Deleted because the queue is meant to be shared.
+         */
+        UICommandQueue(const UICommandQueue&) = delete;
+
+        /**
+         * The copy assignment operator.
+         * Deleted because the queue is meant to be shared.
+         */
+        UICommandQueue& operator = (const UICommandQueue&) = delete;
+
+        /**
+         * Submits a buffer.
+         * It can be called from any thread; empty buffers are ignored.
+         * @param buffer buffer to submit.
+         */
+        void submit(UICommandBuffer buffer);
+
+        /**
+         * Applies the buffers submitted up to the moment of the call.
+         * It must be called from the UI thread only.
+         * If a buffer throws an exception, the buffers after it remain in the queue, and the exception is propagated.
+         * @return number of buffers applied.
+         */
+        size_t applyCommands();
+
+    private:
+        std::mutex m_mutex;
+        std::vector<UICommandBuffer> m_buffers;
+    };
+
+
+} //namespace algui
+
+
+#endif //ALGUI_UICOMMANDQUEUE_HPP
@@ -3,8 +3,15 @@
 
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include "TreeNode.hpp"
+#include "ObjectEvent.hpp"
 #include "Rect.hpp"
+#include "RenderSnapshot.hpp"
+#include "DamageRegion.hpp"
+#include "RenderCache.hpp"
+#include "DisplayList.hpp"
 
 
 namespace algui {
@@ -183,17 +190,138 @@ namespace algui {
          */
         void setGeometryManaged(bool v);
 
+        /**
+         * Checks if change events are deferred.
+         * The default is false.
+         * @return true if change events are deferred, false if they are dispatched synchronously.
+         */
+        bool isDeferredChangeEvents() const;
+
+        /**
+         * Sets the deferred change events state.
+         * When change events are deferred, property changes (e.g. "rectChanged", "visibleChanged") are queued,
+         * instead of being dispatched synchronously; multiple changes of the same type are collapsed into one event,
+         * which is dispatched after the last change, by `dispatchChangeEvents()`.
+         * Events already queued are dispatched, regardless of this state.
+         * @param v if true, change events are deferred, otherwise they are dispatched synchronously.
+         */
+        void setDeferredChangeEvents(bool v);
+
+        /**
+         * Dispatches the queued change events of all nodes, in the order the nodes were queued.
+         * Change events queued while dispatching are also dispatched.
+         * It is invoked automatically by `render()`, before anything is updated.
+         */
+        static void dispatchChangeEvents();
+
+        /**
+         * Checks if the render snapshot of this node is enabled.
+         * The default is false.
+         * @return true if the render snapshot is enabled, false otherwise.
+         */
+        bool isRenderSnapshotEnabled() const;
+
+        /**
+         * Sets the render snapshot state.
+         * While the render snapshot is enabled, `render()` and `render(clipping)` invoked on this node
+         * walk a flattened snapshot of this tree, which is rebuilt only after the structure of the tree changes
+         * (i.e. when children are added, removed or moved, or when nodes are shown, hidden, clipped, unclipped, cached or uncached).
+         * The tree must not be changed structurally from within `paint()` and `paintOverlay()`.
+         * Snapshots can be nested, i.e. enabled on a node and on some of its descendants;
+         * each snapshot is validated independently, but rebuilding one of them makes the next rebuild of the other walk their shared nodes instead of copying them.
+         * @param v if true, the render snapshot is enabled, otherwise it is disabled and released.
+         */
+        void setRenderSnapshotEnabled(bool v);
+
+        /**
+         * Returns the render snapshot of this node.
+         * @return the render snapshot of this node; null if it is disabled.
+         */
+        const RenderSnapshot* getRenderSnapshot() const {
+            return m_renderSnapshot.get();
+        }
+
+        /**
+         * Checks if the subtree of this node is cached.
+         * The default is false.
+         * @return true if the subtree is cached, false otherwise.
+         */
+        bool isCached() const;
+
+        /**
+         * Sets the cached state.
+         * A cached node renders its subtree into a bitmap of the RenderCache, and blits the bitmap on subsequent renders,
+         * until the node or a node of its subtree is invalidated (e.g. it changes its rect, scaling, visibility, structure, interactive state,
+         * or `invalidatePaint()` is invoked on it); the bitmap is dropped when the screen scaling changes.
+         * Painting of a cached subtree is clipped to the screen rectangle of the cached node.
+         * Nodes that change their appearance on every frame should not be cached.
+         * @param v if true, the subtree is cached, otherwise the cache bitmap is released.
+         */
+        void setCached(bool v);
+
+        /**
+         * Checks if the display list of this node is enabled.
+         * The default is false.
+         * @return true if the display list is enabled, false otherwise.
+         */
+        bool isDisplayListEnabled() const;
+
+        /**
+         * Sets the display list state.
+         * While the display list is enabled, `paint()` records its drawing into the list returned by `getDisplayList()`,
+         * and it is invoked only when the list needs to be recorded again, i.e. after the screen rectangle of the node changes,
+         * after `invalidateRect()`, `invalidateScreenScaling()` or `invalidatePaint()` are invoked on it, or after its state changes;
+         * otherwise, rendering replays the recorded list.
+         * @param v if true, the display list is enabled, otherwise it is disabled and released.
+         */
+        void setDisplayListEnabled(bool v);
+
+        /**
+         * Returns the display list that `paint()` shall record its drawing into.
+         * @return the display list of this node; null if it is disabled.
+         */
+        DisplayList* getDisplayList() const {
+            return m_displayList.get();
+        }
+
         /**
          * Updates and paints the node tree.
+         * Nodes outside of the clipping rectangle of the target bitmap are not painted,
+         * and the subtrees of clipped and cached nodes outside of it are skipped.
          */
         virtual void render();
 
         /**
          * Updates and paints the node tree, for every node that falls within the given screen rectangle.
+         * As in `render()`, only the subtrees of clipped and cached nodes outside of the rectangle are skipped,
+         * since children might overflow their unclipped parents.
          * @param clipping screen clipping.
          */
         virtual void render(const Rect& clipping);
 
+        /**
+         * Updates the node tree, and repaints only the screen areas that changed since the last call.
+         * Areas change when nodes move, resize, are shown, hidden, added or removed, change their interactive state,
+         * or when `invalidatePaint()` is invoked on them; they are repainted via `render(clipping)`, once per damaged rectangle.
+         * Damage is tracked for trees whose root has this invoked; the first call paints the whole tree.
+         * The target bitmap must keep its contents between calls.
+         */
+        virtual void renderDamaged();
+
+        /**
+         * Returns the damage region of this tree.
+         * @return the damage region of this tree; null if `renderDamaged()` was never invoked on this.
+         */
+        const DamageRegion* getDamageRegion() const {
+            return m_damageRegion.get();
+        }
+
+        /**
+         * Marks this node for repainting by the next `renderDamaged()` call.
+         * Subclasses shall invoke it when their appearance changes in ways the library does not know of.
+         */
+        void invalidatePaint();
+
         /**
          * Checks intersection with coordinates, i.e. if coordinates lie within this node.
          * The comparison is done against the screen rectangle of the node, if the node is clipped,
@@ -214,6 +342,24 @@ namespace algui {
          */
         UINode* getChildAt(float x, float y, bool enabled = false) const;
 
+        /**
+         * The child at index accessor of TreeNode, which is otherwise hidden by the coordinate-based one.
+         */
+        using TreeNode<UINode>::getChildAt;
+
+        /**
+         * Checks if this node or any of its descendants might have event listeners for the given event type.
+         * The check is based on a summary mask of the event types listened to in this tree,
+         * which is updated when event listeners or children are added or removed;
+         * it might return true even if no node listens to the given event type (see `EventType::getMask()`),
+         * but it never returns false if a node does.
+         * @param eventType type of event.
+         * @return true if a node of this tree might have event listeners for the given event type, false otherwise.
+         */
+        bool hasEventListenersInTree(const EventType& eventType) const {
+            return (_getEventListenerMask() & eventType.getMask()) != 0;
+        }
+
     protected:
         /**
          * Sets the new child state.
@@ -221,6 +367,47 @@ namespace algui {
          */
         void setNewChildState(const std::shared_ptr<UINode>& child) override;
 
+        /**
+         * Updates the event listener mask of this tree.
+         * @param child the removed child.
+         */
+        void setRemovedChildState(const std::shared_ptr<UINode>& child) override;
+
+        /**
+         * Invalidates the render snapshot of this tree.
+         * @param child the moved child.
+         */
+        void setMovedChildState(const std::shared_ptr<UINode>& child) override;
+
+        /**
+         * Dispatches an ObjectEvent<T> that signals a property change of this node.
+         * The event is created only if there are event listeners for it.
+         * If change events are deferred, the event is queued, unless an event of the same type is already queued for this node.
+         * @param eventType type of event.
+         */
+        template <class T> void dispatchChangeEvent(const EventType& eventType) {
+            if (hasEventListeners(eventType)) {
+                if (isDeferredChangeEvents()) {
+                    _queueChangeEvent(eventType, &_dispatchChangeEvent<T>);
+                }
+                else {
+                    _dispatchChangeEvent<T>(this, eventType);
+                }
+            }
+        }
+
+        /**
+         * Adds the event type to the event listener mask of this tree.
+         * @param eventTypeId id of the event type.
+         */
+        void firstEventListenerAdded(size_t eventTypeId) override;
+
+        /**
+         * Marks the event listener mask of this tree for recomputation.
+         * @param eventTypeId id of the event type.
+         */
+        void lastEventListenerRemoved(size_t eventTypeId) override;
+
         /**
          * Sets the RECT_DIRTY flag on this UI node,
          * and the DESCENTANT_RECT_DIRTY flag to all the ancestor nodes,
@@ -285,6 +472,9 @@ namespace algui {
          * Interface for painting the node, using Allegro functions.
          * The default implementation is empty.
          * This is called after all screen props are updated, but before the children.
+         * If the display list of the node is enabled, all drawing shall be recorded into the display list instead.
+         * Drawing through the DrawBatch is batched with the drawing of other nodes;
+         * drawing with Allegro directly shall be preceded by `DrawBatch::flush()`.
          */
         virtual void paint() const {}
 
@@ -292,6 +482,7 @@ namespace algui {
          * Interface for painting above a node's children, using Allegro functions.
          * The default implementation is empty.
          * This is called after all children have been painted.
+         * The same DrawBatch rules as in `paint()` apply.
          */
         virtual void paintOverlay() const {}
 
@@ -301,12 +492,49 @@ namespace algui {
         Scaling m_scaling;
         Scaling m_screenScaling;
         int m_flags;
+        mutable uint64_t m_eventListenerMask;
+        mutable bool m_eventListenerMaskDirty;
+
+        using ChangeEventFunction = void (*)(UINode* node, const EventType& eventType);
+
+        struct ChangeEvent {
+            EventType type;
+            ChangeEventFunction function;
+        };
+
+        std::vector<ChangeEvent> m_changeEvents;
+
+        std::unique_ptr<RenderSnapshot> m_renderSnapshot;
+        std::unique_ptr<DamageRegion> m_damageRegion;
+        std::unique_ptr<RenderCache::Entry> m_renderCache;
+        std::unique_ptr<DisplayList> m_displayList;
+
+        //position of this node in the render snapshot it was last put in
+        uint32_t m_renderSnapshotId;
+        uint32_t m_renderSnapshotIndex;
+
+        //structure epoch of the last structural change in the subtree of this node
+        size_t m_structureStamp;
+
+        //geometry epoch of the last invalidation of the screen geometry in the subtree of this node
+        size_t m_geometryStamp;
 
         void _updateRect();
         void _updateScreenProps(int& flags);
         void _render(int flags);
         void _render(int flags, const Rect& clipping);
-        void _render1(int flags, const Rect& clipping);
+        void _renderSnapshot(int flags, const Rect* clipping);
+        bool _renderCached(int flags);
+        void _renderSubtree(int flags);
+        void _deferScreenProps(int flags);
+        void _paint();
+        bool _isRenderSnapshotValid() const;
+        void _updateRenderSnapshot();
+        void _setStructureDirty();
+        void _setGeometryDirty();
+        void _updateDamage(DamageRegion& damageRegion);
+        void _addDamage(const Rect& rect);
+        void _setDescendantPaintDirty();
         void _setDescentantRectDirty();
         void _setEnabledTree(bool v);
         void _setFocusedTree(bool v);
@@ -314,6 +542,15 @@ namespace algui {
         void _setPressedTree(bool v);
         void _setSelectedTree(bool v);
         void _setErrorTree(bool v);
+        void _addEventListenerMask(uint64_t mask);
+        void _setEventListenerMaskDirty();
+        uint64_t _getEventListenerMask() const;
+        void _queueChangeEvent(const EventType& eventType, ChangeEventFunction function);
+        void _dispatchQueuedChangeEvents();
+
+        template <class T> static void _dispatchChangeEvent(UINode* node, const EventType& eventType) {
+            node->dispatchEvent(eventType, [&]() { return ObjectEvent<T>(eventType, node->sharedFromThis<T>()); });
+        }
 
         friend class InteractiveUINode;
     };
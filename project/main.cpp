@@ -12,8 +12,10 @@
 #include "allegro5/allegro_audio.h"
 
 extern void run_tests();
+extern void run_benchmarks();
 
 #include "algui/InteractiveUINode.hpp"
+#include "algui/DrawBatch.hpp"
 
 using namespace algui;
 
@@ -36,8 +38,8 @@ public:
 protected:
     void paint() const override {
         const Rect& r = getScreenRect();
-        al_draw_filled_rectangle(r.left, r.top, r.right, r.bottom, isEnabledTree() ? al_map_rgb(255, 255, 255) : al_map_rgb(192, 192, 192));
-        al_draw_rectangle(r.left + 0.5f, r.top + 0.5f, r.right, r.bottom, isErrorTree() ? al_map_rgb(255, 0, 0) : al_map_rgb(0, 0, 0), 0);
+        DrawBatch::drawFilledRectangle(r.left, r.top, r.right, r.bottom, isEnabledTree() ? al_map_rgb(255, 255, 255) : al_map_rgb(192, 192, 192));
+        DrawBatch::drawRectangle(r.left + 0.5f, r.top + 0.5f, r.right, r.bottom, isErrorTree() ? al_map_rgb(255, 0, 0) : al_map_rgb(0, 0, 0), 0);
     }
 
 private:
@@ -46,6 +48,7 @@ private:
 
 int main(int argc, char** argv) {
     //run_tests();
+    //run_benchmarks();
     //return 0;
 
     al_init();
@@ -0,0 +1,177 @@
+#include "algui/ChildIndex.hpp"
+
+
+namespace algui {
+
+
+    ChildIndex::ChildIndex()
+        : m_chunkSizes(1, 0)
+    {
+    }
+
+
+    ChildIndex::~ChildIndex() {
+        clear();
+    }
+
+
+    size_t ChildIndex::getSize() const {
+        return m_size;
+    }
+
+
+    void ChildIndex::insert(Entry* entry, Entry* nextEntry) {
+        Chunk* chunk;
+        size_t position;
+
+        //appending fills the last chunk, then starts a new one
+        if (!nextEntry) {
+            if (m_chunks.empty() || m_chunks.back()->entries.size() == CHUNK_SIZE) {
+                _insertChunk(m_chunks.size());
+                _updateChunkSizes();
+            }
+            chunk = m_chunks.back().get();
+            position = chunk->entries.size();
+        }
+
+        //inserting before an entry of a full chunk moves the upper half of the chunk to a new chunk
+        else {
+            chunk = nextEntry->m_chunk;
+            position = nextEntry->m_position;
+            if (chunk->entries.size() == CHUNK_SIZE) {
+                const size_t half = CHUNK_SIZE / 2;
+                _insertChunk(chunk->index + 1);
+                Chunk* nextChunk = m_chunks[chunk->index + 1].get();
+                nextChunk->entries.assign(chunk->entries.begin() + half, chunk->entries.end());
+                chunk->entries.resize(half);
+                _updateEntries(nextChunk, 0);
+                _updateChunkSizes();
+                if (position >= half) {
+                    chunk = nextChunk;
+                    position -= half;
+                }
+            }
+        }
+
+        chunk->entries.insert(chunk->entries.begin() + position, entry);
+        _updateEntries(chunk, position);
+        _addChunkSize(chunk->index, 1);
+        ++m_size;
+    }
+
+
+    void ChildIndex::erase(Entry* entry) {
+        Chunk* chunk = entry->m_chunk;
+        const size_t position = entry->m_position;
+        chunk->entries.erase(chunk->entries.begin() + position);
+        entry->m_chunk = nullptr;
+        entry->m_position = 0;
+        --m_size;
+
+        if (chunk->entries.empty()) {
+            _eraseChunk(chunk->index);
+        }
+        else {
+            _updateEntries(chunk, position);
+            _subtractChunkSize(chunk->index, 1);
+        }
+    }
+
+
+    void ChildIndex::clear() {
+        for (const std::unique_ptr<Chunk>& chunk : m_chunks) {
+            for (Entry* entry : chunk->entries) {
+                entry->m_chunk = nullptr;
+                entry->m_position = 0;
+            }
+        }
+        m_chunks.clear();
+        m_chunkSizes.assign(1, 0);
+        m_size = 0;
+    }
+
+
+    ChildIndex::Entry* ChildIndex::getEntry(size_t index) const {
+        //descend the Fenwick tree, in order to find the chunk with the index
+        size_t chunkIndex = 0;
+        size_t step = 1;
+        for (; step * 2 <= m_chunks.size(); step *= 2) {}
+        for (; step; step /= 2) {
+            if (chunkIndex + step <= m_chunks.size() && m_chunkSizes[chunkIndex + step] <= index) {
+                chunkIndex += step;
+                index -= m_chunkSizes[chunkIndex];
+            }
+        }
+        return m_chunks[chunkIndex]->entries[index];
+    }
+
+
+    size_t ChildIndex::getIndex(const Entry* entry) const {
+        return _getOffset(entry->m_chunk->index) + entry->m_position;
+    }
+
+
+    void ChildIndex::_insertChunk(size_t index) {
+        m_chunks.insert(m_chunks.begin() + index, std::make_unique<Chunk>());
+        m_chunks[index]->entries.reserve(CHUNK_SIZE);
+        for (size_t i = index; i < m_chunks.size(); ++i) {
+            m_chunks[i]->index = i;
+        }
+    }
+
+
+    void ChildIndex::_eraseChunk(size_t index) {
+        m_chunks.erase(m_chunks.begin() + index);
+        for (size_t i = index; i < m_chunks.size(); ++i) {
+            m_chunks[i]->index = i;
+        }
+        _updateChunkSizes();
+    }
+
+
+    void ChildIndex::_updateEntries(Chunk* chunk, size_t begin) {
+        for (size_t i = begin; i < chunk->entries.size(); ++i) {
+            chunk->entries[i]->m_chunk = chunk;
+            chunk->entries[i]->m_position = i;
+        }
+    }
+
+
+    //builds the Fenwick tree in linear time
+    void ChildIndex::_updateChunkSizes() {
+        m_chunkSizes.assign(m_chunks.size() + 1, 0);
+        for (size_t i = 1; i <= m_chunks.size(); ++i) {
+            m_chunkSizes[i] += m_chunks[i - 1]->entries.size();
+            const size_t parent = i + (i & (0 - i));
+            if (parent <= m_chunks.size()) {
+                m_chunkSizes[parent] += m_chunkSizes[i];
+            }
+        }
+    }
+
+
+    void ChildIndex::_addChunkSize(size_t index, size_t size) {
+        for (size_t i = index + 1; i <= m_chunks.size(); i += i & (0 - i)) {
+            m_chunkSizes[i] += size;
+        }
+    }
+
+
+    void ChildIndex::_subtractChunkSize(size_t index, size_t size) {
+        for (size_t i = index + 1; i <= m_chunks.size(); i += i & (0 - i)) {
+            m_chunkSizes[i] -= size;
+        }
+    }
+
+
+    //returns the number of entries in the chunks before the given chunk
+    size_t ChildIndex::_getOffset(size_t index) const {
+        size_t result = 0;
+        for (size_t i = index; i > 0; i -= i & (0 - i)) {
+            result += m_chunkSizes[i];
+        }
+        return result;
+    }
+
+
+} //namespace algui
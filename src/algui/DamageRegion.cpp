@@ -0,0 +1,73 @@
+#include <stdexcept>
+#include "algui/DamageRegion.hpp"
+
+
+namespace algui {
+
+
+    static float _getArea(const Rect& rect) {
+        return rect.getWidth() * rect.getHeight();
+    }
+
+
+    DamageRegion::DamageRegion(size_t maxRectCount)
+        : m_maxRectCount(maxRectCount)
+    {
+        if (maxRectCount == 0) {
+            throw std::invalid_argument("DamageRegion: DamageRegion: maxRectCount is 0.");
+        }
+    }
+
+
+    //the rectangle grows by merging until it overlaps no other rectangle and there is room for it
+    void DamageRegion::add(const Rect& rect) {
+        if (!rect.isValid()) {
+            return;
+        }
+
+        Rect result = rect;
+        for (;;) {
+            bool merged = false;
+            for (size_t index = 0; index < m_rects.size();) {
+                if (m_rects[index].intersects(result)) {
+                    result = Rect::unionOf(result, m_rects[index]);
+                    m_rects[index] = m_rects.back();
+                    m_rects.pop_back();
+                    merged = true;
+                }
+                else {
+                    ++index;
+                }
+            }
+
+            if (m_rects.size() < m_maxRectCount) {
+                if (!merged) {
+                    break;
+                }
+                continue;
+            }
+
+            size_t bestIndex = 0;
+            float bestGrowth = 0;
+            for (size_t index = 0; index < m_rects.size(); ++index) {
+                const float growth = _getArea(Rect::unionOf(result, m_rects[index])) - _getArea(m_rects[index]);
+                if (index == 0 || growth < bestGrowth) {
+                    bestIndex = index;
+                    bestGrowth = growth;
+                }
+            }
+            result = Rect::unionOf(result, m_rects[bestIndex]);
+            m_rects[bestIndex] = m_rects.back();
+            m_rects.pop_back();
+        }
+
+        m_rects.push_back(result);
+    }
+
+
+    void DamageRegion::clear() {
+        m_rects.clear();
+    }
+
+
+} //namespace algui
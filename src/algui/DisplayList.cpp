@@ -0,0 +1,82 @@
+#include "algui/DisplayList.hpp"
+#include "algui/DrawBatch.hpp"
+
+
+namespace algui {
+
+
+    DisplayList::DisplayList() {
+    }
+
+
+    void DisplayList::drawFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+        m_commands.push_back(Command{ CommandType::FILLED_RECTANGLE, 0, color, { x1, y1, x2, y2 }, nullptr, 0 });
+    }
+
+
+    void DisplayList::drawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness) {
+        m_commands.push_back(Command{ CommandType::RECTANGLE, 0, color, { x1, y1, x2, y2, thickness }, nullptr, 0 });
+    }
+
+
+    void DisplayList::drawLine(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness) {
+        m_commands.push_back(Command{ CommandType::LINE, 0, color, { x1, y1, x2, y2, thickness }, nullptr, 0 });
+    }
+
+
+    void DisplayList::drawBitmap(ALLEGRO_BITMAP* bitmap, float x, float y, int flags) {
+        m_commands.push_back(Command{ CommandType::BITMAP, flags, ALLEGRO_COLOR{}, { x, y }, bitmap, 0 });
+    }
+
+
+    void DisplayList::drawScaledBitmap(ALLEGRO_BITMAP* bitmap, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh, int flags) {
+        m_commands.push_back(Command{ CommandType::SCALED_BITMAP, flags, ALLEGRO_COLOR{}, { sx, sy, sw, sh, dx, dy, dw, dh }, bitmap, 0 });
+    }
+
+
+    void DisplayList::drawText(const ALLEGRO_FONT* font, ALLEGRO_COLOR color, float x, float y, int flags, const std::string& text) {
+        m_commands.push_back(Command{ CommandType::TEXT, flags, color, { x, y }, font, m_texts.size() });
+        m_texts.append(text.c_str(), text.size() + 1);
+    }
+
+
+    void DisplayList::clear() {
+        m_commands.clear();
+        m_texts.clear();
+    }
+
+
+    //commands are drawn through the DrawBatch, so that the lists of consecutive nodes are batched together
+    void DisplayList::replay() const {
+        for (const Command& command : m_commands) {
+            const float* args = command.args;
+            switch (command.type) {
+                case CommandType::FILLED_RECTANGLE:
+                    DrawBatch::drawFilledRectangle(args[0], args[1], args[2], args[3], command.color);
+                    break;
+
+                case CommandType::RECTANGLE:
+                    DrawBatch::drawRectangle(args[0], args[1], args[2], args[3], command.color, args[4]);
+                    break;
+
+                case CommandType::LINE:
+                    DrawBatch::drawLine(args[0], args[1], args[2], args[3], command.color, args[4]);
+                    break;
+
+                case CommandType::BITMAP:
+                    DrawBatch::drawBitmap((ALLEGRO_BITMAP*)command.resource, args[0], args[1], command.flags);
+                    break;
+
+                case CommandType::SCALED_BITMAP:
+                    DrawBatch::drawScaledBitmap((ALLEGRO_BITMAP*)command.resource, args[0], args[1], args[2], args[3], args[4], args[5], args[6], args[7], command.flags);
+                    break;
+
+                case CommandType::TEXT:
+                    DrawBatch::drawText((const ALLEGRO_FONT*)command.resource, command.color, args[0], args[1], command.flags, m_texts.c_str() + command.textOffset);
+                    break;
+            }
+        }
+    }
+
+
+} //namespace algui
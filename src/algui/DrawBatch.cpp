@@ -0,0 +1,140 @@
+#include <cmath>
+#include <vector>
+#include <allegro5/allegro_primitives.h>
+#include "algui/DrawBatch.hpp"
+
+
+namespace algui {
+
+
+    //kind of the draws collected so far
+    enum class _BatchKind {
+        NONE,
+        PRIMITIVES,
+        BITMAPS
+    };
+
+
+    static _BatchKind _kind = _BatchKind::NONE;
+    static std::vector<ALLEGRO_VERTEX> _vertices;
+    static DrawBatch::Statistics _statistics;
+
+
+    static void _beginPrimitives() {
+        if (_kind == _BatchKind::BITMAPS) {
+            DrawBatch::flush();
+        }
+        _kind = _BatchKind::PRIMITIVES;
+        ++_statistics.primitiveCount;
+    }
+
+
+    static void _beginBitmaps() {
+        if (_kind == _BatchKind::PRIMITIVES) {
+            DrawBatch::flush();
+        }
+        if (_kind == _BatchKind::NONE) {
+            al_hold_bitmap_drawing(true);
+            _kind = _BatchKind::BITMAPS;
+        }
+        ++_statistics.bitmapCount;
+    }
+
+
+    //a quad is added as two triangles
+    static void _addQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, ALLEGRO_COLOR color) {
+        _vertices.push_back(ALLEGRO_VERTEX{ x1, y1, 0, 0, 0, color });
+        _vertices.push_back(ALLEGRO_VERTEX{ x2, y2, 0, 0, 0, color });
+        _vertices.push_back(ALLEGRO_VERTEX{ x3, y3, 0, 0, 0, color });
+        _vertices.push_back(ALLEGRO_VERTEX{ x1, y1, 0, 0, 0, color });
+        _vertices.push_back(ALLEGRO_VERTEX{ x3, y3, 0, 0, 0, color });
+        _vertices.push_back(ALLEGRO_VERTEX{ x4, y4, 0, 0, 0, color });
+    }
+
+
+    static void _addRect(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+        _addQuad(x1, y1, x2, y1, x2, y2, x1, y2, color);
+    }
+
+
+    void DrawBatch::drawFilledRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color) {
+        _beginPrimitives();
+        _addRect(x1, y1, x2, y2, color);
+    }
+
+
+    void DrawBatch::drawRectangle(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness) {
+        _beginPrimitives();
+        _statistics.primitiveCount += 3;
+        const float h = thickness > 0 ? thickness / 2 : 0.5f;
+        _addRect(x1 - h, y1 - h, x2 + h, y1 + h, color);
+        _addRect(x1 - h, y2 - h, x2 + h, y2 + h, color);
+        _addRect(x1 - h, y1 + h, x1 + h, y2 - h, color);
+        _addRect(x2 - h, y1 + h, x2 + h, y2 - h, color);
+    }
+
+
+    void DrawBatch::drawLine(float x1, float y1, float x2, float y2, ALLEGRO_COLOR color, float thickness) {
+        const float dx = x2 - x1;
+        const float dy = y2 - y1;
+        const float length = std::sqrt(dx * dx + dy * dy);
+        if (length == 0) {
+            return;
+        }
+        _beginPrimitives();
+        const float h = (thickness > 0 ? thickness / 2 : 0.5f) / length;
+        const float nx = -dy * h;
+        const float ny = dx * h;
+        _addQuad(x1 + nx, y1 + ny, x2 + nx, y2 + ny, x2 - nx, y2 - ny, x1 - nx, y1 - ny, color);
+    }
+
+
+    void DrawBatch::drawBitmap(ALLEGRO_BITMAP* bitmap, float x, float y, int flags) {
+        _beginBitmaps();
+        al_draw_bitmap(bitmap, x, y, flags);
+    }
+
+
+    void DrawBatch::drawScaledBitmap(ALLEGRO_BITMAP* bitmap, float sx, float sy, float sw, float sh, float dx, float dy, float dw, float dh, int flags) {
+        _beginBitmaps();
+        al_draw_scaled_bitmap(bitmap, sx, sy, sw, sh, dx, dy, dw, dh, flags);
+    }
+
+
+    void DrawBatch::drawText(const ALLEGRO_FONT* font, ALLEGRO_COLOR color, float x, float y, int flags, const char* text) {
+        _beginBitmaps();
+        al_draw_text(font, color, x, y, flags, text);
+    }
+
+
+    void DrawBatch::flush() {
+        switch (_kind) {
+            case _BatchKind::NONE:
+                return;
+
+            case _BatchKind::PRIMITIVES:
+                al_draw_prim(_vertices.data(), nullptr, nullptr, 0, (int)_vertices.size(), ALLEGRO_PRIM_TRIANGLE_LIST);
+                _vertices.clear();
+                ++_statistics.primitiveBatchCount;
+                break;
+
+            case _BatchKind::BITMAPS:
+                al_hold_bitmap_drawing(false);
+                ++_statistics.bitmapBatchCount;
+                break;
+        }
+        _kind = _BatchKind::NONE;
+    }
+
+
+    DrawBatch::Statistics DrawBatch::getStatistics() {
+        return _statistics;
+    }
+
+
+    void DrawBatch::resetStatistics() {
+        _statistics = Statistics();
+    }
+
+
+} //namespace algui
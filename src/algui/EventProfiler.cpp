@@ -0,0 +1,88 @@
+#include <optional>
+#include <algorithm>
+#include "algui/EventProfiler.hpp"
+
+
+namespace algui {
+
+
+    static bool _eventListenerProfilingEnabled = false;
+    static std::vector<std::optional<EventTypeProfile>> _eventTypeProfiles;
+    static std::vector<std::optional<EventListenerProfile>> _eventListenerProfiles;
+
+
+    template <class T> static std::vector<T> _getProfiles(const std::vector<std::optional<T>>& profiles) {
+        std::vector<T> result;
+        for (const std::optional<T>& profile : profiles) {
+            if (profile) {
+                result.push_back(*profile);
+            }
+        }
+        return result;
+    }
+
+
+    bool EventProfiler::isEventListenerProfilingEnabled() {
+        return _eventListenerProfilingEnabled;
+    }
+
+
+    void EventProfiler::setEventListenerProfilingEnabled(bool v) {
+        _eventListenerProfilingEnabled = v;
+    }
+
+
+    EventProfile EventProfiler::getProfile(bool reset) {
+        EventProfile result{ _getProfiles(_eventTypeProfiles), _getProfiles(_eventListenerProfiles) };
+        if (reset) {
+            EventProfiler::reset();
+        }
+        return result;
+    }
+
+
+    void EventProfiler::reset() {
+        _eventTypeProfiles.clear();
+        _eventListenerProfiles.clear();
+    }
+
+
+    void EventProfiler::recordDispatch(const EventType& eventType, size_t listenerInvocationCount, Clock::duration time) {
+        const size_t eventTypeId = eventType.getId();
+        if (eventTypeId >= _eventTypeProfiles.size()) {
+            _eventTypeProfiles.resize(eventTypeId + 1);
+        }
+
+        std::optional<EventTypeProfile>& profile = _eventTypeProfiles[eventTypeId];
+        if (!profile) {
+            profile.emplace(EventTypeProfile{ eventType });
+        }
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time);
+        ++profile->dispatchCount;
+        profile->listenerInvocationCount += listenerInvocationCount;
+        profile->totalTime += ns;
+        profile->maxTime = std::max(profile->maxTime, ns);
+    }
+
+
+    void EventProfiler::recordListenerInvocation(const EventTarget::EventListenerId& id, const EventType& eventType, Clock::duration time) {
+        const size_t index = id.m_index;
+        if (index >= _eventListenerProfiles.size()) {
+            _eventListenerProfiles.resize(index + 1);
+        }
+
+        //a slot reused by a new event listener starts a new profile
+        std::optional<EventListenerProfile>& profile = _eventListenerProfiles[index];
+        if (!profile || profile->id != id) {
+            profile.emplace(EventListenerProfile{ id, eventType });
+        }
+
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time);
+        ++profile->invocationCount;
+        profile->totalTime += ns;
+        profile->maxTime = std::max(profile->maxTime, ns);
+    }
+
+
+} //namespace algui
@@ -1,80 +1,272 @@
 #include <stdexcept>
+#include <algorithm>
+#include <utility>
 #include "algui/EventTarget.hpp"
+#include "algui/EventProfiler.hpp"
 
 
 namespace algui {
 
 
+    static constexpr size_t _FIRST_EVENT_LISTENER_CHUNK_SIZE = 4;
+    static constexpr size_t _MAX_EVENT_LISTENER_CHUNK_SHIFT = 8;
+
+
+    class _DispatchDepthGuard {
+    public:
+        _DispatchDepthGuard(size_t& depth) : m_depth(depth) {
+            ++m_depth;
+        }
+
+        ~_DispatchDepthGuard() {
+            --m_depth;
+        }
+
+    private:
+        size_t& m_depth;
+    };
+
+
+    template <class T, class L> class _EventListenerTable {
+    public:
+        struct Entry {
+            T* target;
+            L* listener;
+            uint32_t eventTypeId;
+            uint32_t generation;
+        };
+
+        Entry* get(uint32_t index, uint32_t generation) {
+            if (index < m_entries.size()) {
+                Entry& entry = m_entries[index];
+                if (entry.generation == generation && entry.target) {
+                    return &entry;
+                }
+            }
+            return nullptr;
+        }
+
+        std::pair<uint32_t, uint32_t> add(T* target, L* listener, uint32_t eventTypeId) {
+            uint32_t index;
+            if (m_firstFree != NONE) {
+                index = m_firstFree;
+                m_firstFree = m_entries[index].eventTypeId;
+            }
+            else {
+                index = (uint32_t)m_entries.size();
+                m_entries.push_back(Entry{ nullptr, nullptr, 0, 1 });
+            }
+            Entry& entry = m_entries[index];
+            entry.target = target;
+            entry.listener = listener;
+            entry.eventTypeId = eventTypeId;
+            return { index, entry.generation };
+        }
+
+        uint32_t getGeneration(uint32_t index) const {
+            return m_entries[index].generation;
+        }
+
+        void remove(uint32_t index) {
+            Entry& entry = m_entries[index];
+            entry.target = nullptr;
+            entry.listener = nullptr;
+            entry.generation = entry.generation + 1 ? entry.generation + 1 : 1;
+            entry.eventTypeId = m_firstFree;
+            m_firstFree = index;
+        }
+
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+        std::vector<Entry> m_entries;
+        uint32_t m_firstFree{ NONE };
+    };
+
+
+    template <class T, class L> static _EventListenerTable<T, L>& _getEventListenerTable() {
+        static _EventListenerTable<T, L> table;
+        return table;
+    }
+
+
     EventTarget::~EventTarget() {
+        auto& table = _getEventListenerTable<EventTarget, EventListener>();
+
         for (const EventListenerId& id : m_eventListenerIds) {
-            if (id.m_eventTarget) {
-                id.m_eventTarget->removeEventListener(id);
+            auto* entry = table.get(id.m_index, id.m_generation);
+            if (entry) {
+                entry->target->_removeEventListener(entry->listener, entry->eventTypeId);
+            }
+        }
+
+        for (const EventListenerQueue& queue : m_eventListenerQueues) {
+            for (EventListener* listener = queue.first; listener; listener = listener->next) {
+                table.remove(listener->idIndex);
             }
         }
     }
 
 
-    EventTarget::EventListenerId::EventListenerId(EventListenerId&& id)
-        : m_eventTarget(id.m_eventTarget)
-        , m_eventType(std::move(id.m_eventType))
-        , m_it(std::move(id.m_it))
-    {
-        id.m_eventTarget = nullptr;
+    bool EventTarget::EventListenerId::isValid() const {
+        return _getEventListenerTable<EventTarget, EventListener>().get(m_index, m_generation) != nullptr;
     }
 
 
-    EventTarget::EventListenerId& EventTarget::EventListenerId::operator = (EventListenerId&& id) noexcept {
-        EventTarget* eventTarget = id.m_eventTarget;
-        m_eventType = std::move(id.m_eventType);
-        m_it = std::move(id.m_it);
-        id.m_eventTarget = nullptr;
-        m_eventTarget = eventTarget;
-        return *this;
-    }
+    EventTarget::EventListenerId EventTarget::addEventListener(const EventType& eventType, EventListenerFunction&& func, bool prioritized) {
+        const size_t eventTypeId = eventType.getId();
+        if (eventTypeId >= m_eventListenerQueues.size()) {
+            m_eventListenerQueues.resize(eventTypeId + 1);
+        }
 
+        EventListener* listener = _allocEventListener();
+        listener->function = std::move(func);
 
-    EventTarget::EventListenerId::EventListenerId(EventTarget* eventTarget, std::string&& eventType, std::list<EventListenerFunction>::iterator&& it)
-        : m_eventTarget(eventTarget)
-        , m_eventType(std::move(eventType))
-        , m_it(std::move(it))
-    {
-    }
+        EventListenerQueue& queue = m_eventListenerQueues[eventTypeId];
+        const bool first = !queue.first;
+        if (prioritized) {
+            listener->prev = nullptr;
+            listener->next = queue.first;
+            (queue.first ? queue.first->prev : queue.last) = listener;
+            queue.first = listener;
+        }
+        else {
+            listener->prev = queue.last;
+            listener->next = nullptr;
+            (queue.last ? queue.last->next : queue.first) = listener;
+            queue.last = listener;
+        }
+
+        const auto [index, generation] = _getEventListenerTable<EventTarget, EventListener>().add(this, listener, (uint32_t)eventTypeId);
+        listener->idIndex = index;
 
+        if (first) {
+            firstEventListenerAdded(eventTypeId);
+        }
 
-    EventTarget::EventListenerId EventTarget::addEventListener(std::string&& eventType, EventListenerFunction&& func, bool prioritized) {
-        std::list<EventListenerFunction>& list = m_eventListenerFunctions[eventType];
-        auto it = list.insert(prioritized ? list.begin() : list.end(), std::move(func));
-        return { this, std::move(eventType), std::move(it) };
+        return { index, generation };
     }
 
 
     void EventTarget::removeEventListener(const EventListenerId& id) {
-        if (id.m_eventTarget != this) {
+        auto* entry = _getEventListenerTable<EventTarget, EventListener>().get(id.m_index, id.m_generation);
+        if (!entry || entry->target != this) {
             throw std::invalid_argument("EventTarget: removeEventListener: invalid id.");
         }
-        auto it = m_eventListenerFunctions.find(id.m_eventType);
-        if (it != m_eventListenerFunctions.end()) {
-            it->second.erase(id.m_it);
-            id.m_eventTarget = nullptr;
-        }
+        _removeEventListener(entry->listener, entry->eventTypeId);
     }
 
 
+    //with ALGUI_EVENT_PROFILING, the dispatch is timed, and so is each listener invocation, if enabled;
+    //the id of a listener is taken before its invocation, since the listener might remove itself
     bool EventTarget::dispatchEvent(const Event& event) const {
-        auto it = m_eventListenerFunctions.find(event.getType());
-        if (it != m_eventListenerFunctions.end()) {
-            for (const EventListenerFunction& func : it->second) {
-                if (func(event)) {
-                    return true;
+        const size_t eventTypeId = event.getEventType().getId();
+
+#ifdef ALGUI_EVENT_PROFILING
+        const EventProfiler::Clock::time_point startTime = EventProfiler::Clock::now();
+        const bool profileListeners = EventProfiler::isEventListenerProfilingEnabled();
+        size_t listenerInvocationCount = 0;
+#endif
+
+        bool result = false;
+        if (eventTypeId < m_eventListenerQueues.size()) {
+            _DispatchDepthGuard guard(m_dispatchDepth);
+            for (EventListener* listener = m_eventListenerQueues[eventTypeId].first; listener; listener = listener->next) {
+                if (listener->prev == listener) {
+                    continue;
+                }
+#ifdef ALGUI_EVENT_PROFILING
+                ++listenerInvocationCount;
+                EventListenerId id;
+                EventProfiler::Clock::time_point listenerStartTime;
+                if (profileListeners) {
+                    id = EventListenerId(listener->idIndex, _getEventListenerTable<EventTarget, EventListener>().getGeneration(listener->idIndex));
+                    listenerStartTime = EventProfiler::Clock::now();
+                }
+#endif
+                result = listener->function(event);
+#ifdef ALGUI_EVENT_PROFILING
+                if (profileListeners) {
+                    EventProfiler::recordListenerInvocation(id, event.getEventType(), EventProfiler::Clock::now() - listenerStartTime);
+                }
+#endif
+                if (result) {
+                    break;
                 }
             }
         }
-        return false;
+
+        if (m_dispatchDepth == 0 && !m_removedEventListeners.empty()) {
+            const_cast<EventTarget*>(this)->_freeRemovedEventListeners();
+        }
+
+#ifdef ALGUI_EVENT_PROFILING
+        EventProfiler::recordDispatch(event.getEventType(), listenerInvocationCount, EventProfiler::Clock::now() - startTime);
+#endif
+        return result;
+    }
+
+
+    uint64_t EventTarget::getEventListenerMask() const {
+        uint64_t result = 0;
+        for (size_t eventTypeId = 0; eventTypeId < m_eventListenerQueues.size(); ++eventTypeId) {
+            if (m_eventListenerQueues[eventTypeId].first) {
+                result |= EventType::getMask(eventTypeId);
+            }
+        }
+        return result;
     }
 
 
-    void EventTarget::addEventListenerId(EventListenerId&& id) {
-        m_eventListenerIds.push_back(std::move(id));
+    void EventTarget::addEventListenerId(EventListenerId id) {
+        m_eventListenerIds.push_back(id);
+    }
+
+
+    EventTarget::EventListener* EventTarget::_allocEventListener() {
+        if (!m_freeEventListener) {
+            const size_t chunkSize = _FIRST_EVENT_LISTENER_CHUNK_SIZE << std::min(m_eventListenerChunks.size(), _MAX_EVENT_LISTENER_CHUNK_SHIFT);
+            std::unique_ptr<EventListener[]> chunk = std::make_unique<EventListener[]>(chunkSize);
+            for (size_t i = 0; i < chunkSize; ++i) {
+                chunk[i].next = i + 1 < chunkSize ? &chunk[i + 1] : nullptr;
+            }
+            m_freeEventListener = &chunk[0];
+            m_eventListenerChunks.push_back(std::move(chunk));
+        }
+        EventListener* listener = m_freeEventListener;
+        m_freeEventListener = listener->next;
+        return listener;
+    }
+
+
+    void EventTarget::_removeEventListener(EventListener* listener, size_t eventTypeId) {
+        EventListenerQueue& queue = m_eventListenerQueues[eventTypeId];
+        (listener->prev ? listener->prev->next : queue.first) = listener->next;
+        (listener->next ? listener->next->prev : queue.last) = listener->prev;
+
+        _getEventListenerTable<EventTarget, EventListener>().remove(listener->idIndex);
+
+        //while dispatching, the listener might be executing or be the next one to execute;
+        //its memory and next pointer are kept intact until dispatching ends
+        listener->prev = listener;
+        m_removedEventListeners.push_back(listener);
+        if (m_dispatchDepth == 0) {
+            _freeRemovedEventListeners();
+        }
+
+        if (!queue.first) {
+            lastEventListenerRemoved(eventTypeId);
+        }
+    }
+
+
+    void EventTarget::_freeRemovedEventListeners() {
+        for (EventListener* listener : m_removedEventListeners) {
+            listener->function = nullptr;
+            listener->prev = nullptr;
+            listener->next = m_freeEventListener;
+            m_freeEventListener = listener;
+        }
+        m_removedEventListeners.clear();
     }
 
 
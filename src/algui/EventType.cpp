@@ -0,0 +1,55 @@
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include "algui/EventType.hpp"
+
+
+namespace algui {
+
+
+    template <class E> class _EventTypeRegistry {
+    public:
+        const E* get(const std::string_view& name) {
+            std::lock_guard lock(m_mutex);
+            const auto it = m_entries.find(name);
+            if (it != m_entries.end()) {
+                return it->second.get();
+            }
+            std::unique_ptr<E> entry = std::make_unique<E>();
+            entry->storage = name;
+            entry->name = entry->storage;
+            entry->id = m_entries.size();
+            const E* result = entry.get();
+            m_entries.emplace(entry->name, std::move(entry));
+            return result;
+        }
+
+        size_t getCount() {
+            std::lock_guard lock(m_mutex);
+            return m_entries.size();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_map<std::string_view, std::unique_ptr<E>> m_entries;
+    };
+
+
+    template <class E> static _EventTypeRegistry<E>& _getEventTypeRegistry() {
+        static _EventTypeRegistry<E> registry;
+        return registry;
+    }
+
+
+    EventType::EventType(const std::string_view& name)
+        : m_entry(_getEventTypeRegistry<Entry>().get(name))
+    {
+    }
+
+
+    size_t EventType::getCount() {
+        return _getEventTypeRegistry<Entry>().getCount();
+    }
+
+
+} //namespace algui
@@ -1,3 +1,6 @@
+#include <string>
+#include <optional>
+#include <cstdint>
 #include "algui/InteractiveUINode.hpp"
 #include "algui/ObjectEvent.hpp"
 #include "algui/KeyboardEvent.hpp"
@@ -29,6 +32,38 @@ namespace algui {
     static std::any _draggedData;
     static bool _resetPrevMousePosition = false;
     static std::vector<DraggedImage>* _draggedImages = nullptr;
+    static bool _draggedImagesRendered = false;
+
+
+    static const EventType _enabledChangedEventType("enabledChanged");
+    static const EventType _gotFocusEventType("gotFocus");
+    static const EventType _lostFocusEventType("lostFocus");
+    static const EventType _highlightedChangedEventType("highlightedChanged");
+    static const EventType _pressedChangedEventType("pressedChanged");
+    static const EventType _selectedChangedEventType("selectedChanged");
+    static const EventType _errorChangedEventType("errorChanged");
+    static const EventType _mouseMoveEventType("mouseMove");
+    static const EventType _mouseEnterEventType("mouseEnter");
+    static const EventType _mouseLeaveEventType("mouseLeave");
+    static const EventType _mouseWheelEventType("mouseWheel");
+    static const EventType _mouseButtonDownEventType("mouseButtonDown");
+    static const EventType _mouseButtonUpEventType("mouseButtonUp");
+    static const EventType _dragEventType("drag");
+    static const EventType _dragEnterEventType("dragEnter");
+    static const EventType _dragLeaveEventType("dragLeave");
+    static const EventType _dragWheelEventType("dragWheel");
+    static const EventType _dropEventType("drop");
+    static const EventType _keyDownEventType("keyDown");
+    static const EventType _keyUpEventType("keyUp");
+    static const EventType _keyCharEventType("keyChar");
+    static const EventType _dragKeyDownEventType("dragKeyDown");
+    static const EventType _dragKeyUpEventType("dragKeyUp");
+    static const EventType _dragKeyCharEventType("dragKeyChar");
+    static const EventType _timerEventType("timer");
+
+
+    //delegated event types, by event type id
+    static std::vector<std::optional<EventType>> _delegatedEventTypes;
 
 
     static float _distance(float x1, float y1, float x2, float y2) {
@@ -38,9 +73,161 @@ namespace algui {
     }
 
 
-    template <class T, class E>
-    static bool _dispatchEvent(T* object, const E& event) {
-        return object ? object->dispatchEvent(event) : false;
+    static const EventType& _getDelegatedEventTypeOf(const EventType& type) {
+        const size_t eventTypeId = type.getId();
+        if (eventTypeId >= _delegatedEventTypes.size()) {
+            _delegatedEventTypes.resize(eventTypeId + 1);
+        }
+        if (!_delegatedEventTypes[eventTypeId]) {
+            _delegatedEventTypes[eventTypeId] = EventType(std::string("delegated:") + std::string(type.getName()));
+        }
+        return *_delegatedEventTypes[eventTypeId];
+    }
+
+
+    //returns nothing if no delegated event listener was ever added for the given type
+    static std::optional<EventType> _findDelegatedEventTypeOf(const EventType& type) {
+        const size_t eventTypeId = type.getId();
+        return eventTypeId < _delegatedEventTypes.size() ? _delegatedEventTypes[eventTypeId] : std::nullopt;
+    }
+
+
+    //sets an inherited tree state in pre-order; subtrees whose state does not change are skipped
+    template <class GetValue, class GetTreeValue, class SetTreeValue>
+    static void _setTreeState(UINode* node, bool parentTreeValue, const GetValue& getValue, const GetTreeValue& getTreeValue, const SetTreeValue& setTreeValue) {
+        if (!node) {
+            return;
+        }
+        const auto range = node->getPreorderRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode* current = &*it;
+            const bool parentValue = current == node ? parentTreeValue : getTreeValue(current->getParentPtr());
+            InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(current);
+            const bool treeValue = inode ? getValue(inode, parentValue) : parentValue;
+            if (treeValue == getTreeValue(current)) {
+                it.skipChildren();
+            }
+            else {
+                setTreeValue(current, treeValue);
+            }
+        }
+    }
+
+
+    /*
+        Path of an event walk for one event type, from the root of the walk to the current node,
+        along with the ancestors that have delegated event listeners for the type.
+
+        Walks enter nodes top-down, either in pre-order or along a path; entering a node drops the entries
+        that are not its ancestors, so the cost per node is amortized constant, and delegated events
+        are dispatched to the delegating ancestors only.
+        If no delegated event listener was ever added for the type, the path does nothing.
+     */
+    class InteractiveUINode::_EventPath {
+    public:
+        //the delegating ancestors of the root are collected once
+        _EventPath(const EventType& type, UINode* root)
+            : m_type(type)
+            , m_delegatedType(_findDelegatedEventTypeOf(type))
+        {
+            if (!m_delegatedType || !root) {
+                return;
+            }
+            for (UINode* node = root->getParentPtr(); node; node = node->getParentPtr()) {
+                InteractiveUINode* inode = node->as<InteractiveUINode>();
+                if (inode && inode->hasEventListeners(*m_delegatedType)) {
+                    m_delegators.insert(m_delegators.begin(), _Delegator{ inode, 0 });
+                }
+            }
+        }
+
+        const EventType& getEventType() const {
+            return m_type;
+        }
+
+        //the parent of the node shall have been entered last, or the node shall be the root of the walk
+        void enter(UINode* node) {
+            if (!m_delegatedType) {
+                return;
+            }
+            while (!m_path.empty() && m_path.back() != node->getParentPtr()) {
+                m_path.pop_back();
+            }
+            while (!m_delegators.empty() && m_delegators.back().depth > m_path.size()) {
+                m_delegators.pop_back();
+            }
+            m_path.push_back(node);
+            InteractiveUINode* inode = node->as<InteractiveUINode>();
+            if (inode && inode->hasEventListeners(*m_delegatedType)) {
+                m_delegators.push_back(_Delegator{ inode, m_path.size() });
+            }
+        }
+
+        //true if the subtree of an entered node has listeners for the type, or is under a delegating node
+        bool hasEventListenersInTree(UINode* node) const {
+            return node->hasEventListenersInTree(m_type) || (m_delegatedType && (!m_delegators.empty() || node->hasEventListenersInTree(*m_delegatedType)));
+        }
+
+        //dispatches the event to the node, then to its delegating ancestors
+        bool dispatchEvent(InteractiveUINode* node, const Event& event) {
+            return node && (node->dispatchEvent(event) || dispatchDelegatedEvent(node, event));
+        }
+
+        //dispatches the event to the delegating ancestors of the node, closest first
+        bool dispatchDelegatedEvent(InteractiveUINode* node, const Event& event) {
+            if (!node || !_hasDelegators(node)) {
+                return false;
+            }
+            const DelegatedEvent<InteractiveUINode> delegatedEvent(*m_delegatedType, event, node);
+            for (size_t index = m_delegators.size(); index > 0; --index) {
+                InteractiveUINode* delegator = m_delegators[index - 1].node;
+                if (delegator != node && delegator->dispatchEvent(delegatedEvent)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool dispatchMouseEvent(InteractiveUINode* node, const ALLEGRO_EVENT& event, bool capture) {
+            if (node && (node->hasEventListeners(m_type) || _hasDelegators(node))) {
+                return dispatchEvent(node, MouseEvent(m_type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, capture));
+            }
+            return false;
+        }
+
+    private:
+        //depth is the size of the path when the delegator was entered; 0 for ancestors of the root
+        struct _Delegator {
+            InteractiveUINode* node;
+            size_t depth;
+        };
+
+        const EventType& m_type;
+        const std::optional<EventType> m_delegatedType;
+        std::vector<UINode*> m_path;
+        std::vector<_Delegator> m_delegators;
+
+        //the node is entered again, in case a walk returns to it from its children
+        bool _hasDelegators(InteractiveUINode* node) {
+            enter(node);
+            return m_delegators.size() > (!m_delegators.empty() && m_delegators.back().node == node ? 1 : 0);
+        }
+    };
+
+
+    //the queue is held by value, in case a listener replaces the queue of the node
+    static void _dispatchPostedEvents(const std::shared_ptr<PostedEventQueue> queue) {
+        if (queue) {
+            queue->dispatchEvents();
+        }
+    }
+
+
+    //the queue is held by value, in case a command replaces the queue of the node
+    static void _applyCommands(const std::shared_ptr<UICommandQueue> queue) {
+        if (queue) {
+            queue->applyCommands();
+        }
     }
 
 
@@ -71,17 +258,34 @@ namespace algui {
 
 
     void InteractiveUINode::render() {
+        _applyCommands(m_commandQueue);
+        _dispatchPostedEvents(m_postedEventQueue);
         UINode::render();
         _renderDraggedImages(getScreenScaling());
     }
 
 
     void InteractiveUINode::render(const Rect& clipping) {
+        _applyCommands(m_commandQueue);
+        _dispatchPostedEvents(m_postedEventQueue);
         UINode::render(clipping);
         _renderDraggedImages(getScreenScaling());
     }
 
 
+    //the frame after dragging ends is also rendered whole, in order to erase the last dragged images
+    void InteractiveUINode::renderDamaged() {
+        if (_draggedImages || _draggedImagesRendered) {
+            _draggedImagesRendered = _draggedImages != nullptr;
+            render();
+            return;
+        }
+        _applyCommands(m_commandQueue);
+        _dispatchPostedEvents(m_postedEventQueue);
+        UINode::renderDamaged();
+    }
+
+
     std::shared_ptr<InteractiveUINode> InteractiveUINode::getParent() const {
         InteractiveUINode* inode = getParentPtr();
         return inode ? inode->sharedFromThis<InteractiveUINode>() : nullptr;
@@ -174,6 +378,11 @@ namespace algui {
 
 
     InteractiveUINode* InteractiveUINode::getRootPtr() const {
+        //the cached root is the result, unless it is not an interactive node
+        InteractiveUINode* root = dynamic_cast<InteractiveUINode*>(UINode::getRootPtr());
+        if (root) {
+            return root;
+        }
         InteractiveUINode* result = const_cast<InteractiveUINode*>(this);
         for (UINode* node = UINode::getParentPtr(); node; node = node->getParentPtr()) {
             InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
@@ -197,7 +406,7 @@ namespace algui {
             }
             m_flags = v ? m_flags | ENABLED : m_flags & ~ENABLED;
             _setEnabledTree(this, !UINode::getParentPtr() || UINode::getParentPtr()->isEnabledTree());
-            dispatchEvent(ObjectEvent<InteractiveUINode>("enabledChanged", sharedFromThis<InteractiveUINode>()));
+            dispatchChangeEvent<InteractiveUINode>(_enabledChangedEventType);
         }
     }
 
@@ -226,19 +435,13 @@ namespace algui {
             }
             _focusedNode = this;
             _setFocusedTree(this);
-            ObjectEvent<InteractiveUINode> event("gotFocus", sharedFromThis<InteractiveUINode>());
-            for (InteractiveUINode* inode = this; inode; inode = inode->getParentPtr()) {
-                inode->dispatchEvent(event);
-            }
+            _dispatchFocusEvent(_gotFocusEventType);
         }
 
         else {
             _focusedNode = nullptr;
             _setFocusedTree(this);
-            ObjectEvent<InteractiveUINode> event("lostFocus", sharedFromThis<InteractiveUINode>());
-            for (InteractiveUINode* inode = this; inode; inode = inode->getParentPtr()) {
-                inode->dispatchEvent(event);
-            }
+            _dispatchFocusEvent(_lostFocusEventType);
         }
 
         return true;
@@ -254,7 +457,7 @@ namespace algui {
         if (v != isHighlighted()) {
             m_flags = v ? m_flags | HIGHLIGHTED : m_flags & ~HIGHLIGHTED;
             _setHighlightedTree(this, UINode::getParentPtr() && UINode::getParentPtr()->isHighlightedTree());
-            dispatchEvent(ObjectEvent<InteractiveUINode>("highlightedChanged", sharedFromThis<InteractiveUINode>()));
+            dispatchChangeEvent<InteractiveUINode>(_highlightedChangedEventType);
         }
     }
 
@@ -268,7 +471,7 @@ namespace algui {
         if (v != isPressed()) {
             m_flags = v ? m_flags | PRESSED : m_flags & ~PRESSED;
             _setPressedTree(this, UINode::getParentPtr() && UINode::getParentPtr()->isPressedTree());
-            dispatchEvent(ObjectEvent<InteractiveUINode>("pressedChanged", sharedFromThis<InteractiveUINode>()));
+            dispatchChangeEvent<InteractiveUINode>(_pressedChangedEventType);
         }
     }
 
@@ -282,7 +485,7 @@ namespace algui {
         if (v != isSelected()) {
             m_flags = v ? m_flags | SELECTED : m_flags & ~SELECTED;
             _setSelectedTree(this, UINode::getParentPtr() && UINode::getParentPtr()->isSelectedTree());
-            dispatchEvent(ObjectEvent<InteractiveUINode>("selectedChanged", sharedFromThis<InteractiveUINode>()));
+            dispatchChangeEvent<InteractiveUINode>(_selectedChangedEventType);
         }
     }
 
@@ -296,7 +499,7 @@ namespace algui {
         if (v != isError()) {
             m_flags = v ? m_flags | ERROR : m_flags & ~ERROR;
              _setErrorTree(this, UINode::getParentPtr() && UINode::getParentPtr()->isErrorTree());
-             dispatchEvent(ObjectEvent<InteractiveUINode>("errorChanged", sharedFromThis<InteractiveUINode>()));
+             dispatchChangeEvent<InteractiveUINode>(_errorChangedEventType);
         }
     }
 
@@ -348,7 +551,35 @@ namespace algui {
     }
 
 
+    const std::shared_ptr<PostedEventQueue>& InteractiveUINode::getPostedEventQueue() {
+        if (!m_postedEventQueue) {
+            m_postedEventQueue = std::make_shared<PostedEventQueue>();
+        }
+        return m_postedEventQueue;
+    }
+
+
+    void InteractiveUINode::setPostedEventQueue(const std::shared_ptr<PostedEventQueue>& queue) {
+        m_postedEventQueue = queue;
+    }
+
+
+    const std::shared_ptr<UICommandQueue>& InteractiveUINode::getCommandQueue() {
+        if (!m_commandQueue) {
+            m_commandQueue = std::make_shared<UICommandQueue>();
+        }
+        return m_commandQueue;
+    }
+
+
+    void InteractiveUINode::setCommandQueue(const std::shared_ptr<UICommandQueue>& queue) {
+        m_commandQueue = queue;
+    }
+
+
     bool InteractiveUINode::doEvent(const ALLEGRO_EVENT& event) {
+        _dispatchPostedEvents(m_postedEventQueue);
+
         if (_resetPrevMousePosition) {
             _resetPrevMousePosition = false;
             _prevMouseEvent.mouse.x = -1;
@@ -360,14 +591,14 @@ namespace algui {
 
             if (event.mouse.dx || event.mouse.dy) {
                 result = _dragAndDrop ? 
-                         _doRootMouseMoveEvent("drag", "dragEnter", "dragLeave", this, event) : 
-                         _doRootMouseMoveEvent("mouseMove", "mouseEnter", "mouseLeave", this, event);
+                         _doRootMouseMoveEvent(_dragEventType, _dragEnterEventType, _dragLeaveEventType, this, event) : 
+                         _doRootMouseMoveEvent(_mouseMoveEventType, _mouseEnterEventType, _mouseLeaveEventType, this, event);
             }
 
             if (event.mouse.dz || event.mouse.dw) {
                 result = _dragAndDrop ? 
-                         _doMouseButtonEvent("dragWheel", this, event) : 
-                         _doMouseButtonEvent("mouseWheel", this, event);
+                         _doRootMouseButtonEvent(_dragWheelEventType, this, event) : 
+                         _doRootMouseButtonEvent(_mouseWheelEventType, this, event);
             }
 
             _prevMouseEvent = event;
@@ -381,7 +612,7 @@ namespace algui {
             if (_buttonDownEvent.mouse.button == 0) {
                 _buttonDownEvent = event;
             }
-            bool result = _doMouseButtonEvent("mouseButtonDown", this, event);
+            bool result = _doRootMouseButtonEvent(_mouseButtonDownEventType, this, event);
             _prevMouseEvent = event;
             return result;
         }
@@ -389,7 +620,7 @@ namespace algui {
         if (event.type == ALLEGRO_EVENT_MOUSE_BUTTON_UP) {
             if (_dragAndDrop) {
                 if (event.mouse.button == _dragAndDropButton) {
-                    bool result = _doMouseButtonEvent("drop", this, event);
+                    bool result = _doRootMouseButtonEvent(_dropEventType, this, event);
                     _prevMouseEvent = event;
                     endDragAndDrop();
                     return result;
@@ -400,7 +631,7 @@ namespace algui {
                 if (event.mouse.button == _buttonDownEvent.mouse.button) {
                     _buttonDownEvent.mouse.button = 0;
                 }
-                bool result = _doMouseButtonEvent("mouseButtonUp", this, event);
+                bool result = _doRootMouseButtonEvent(_mouseButtonUpEventType, this, event);
                 _prevMouseEvent = event;
                 return result;
             }
@@ -408,24 +639,24 @@ namespace algui {
 
         if (event.type == ALLEGRO_EVENT_KEY_DOWN) {
             return _dragAndDrop ? 
-                   _doDragKeyEvent("dragKeyDown", this, event, _prevMouseEvent) : 
-                   _doRootKeyboardEvent("keyDown", this, event);
+                   _doRootDragKeyEvent(_dragKeyDownEventType, this, event, _prevMouseEvent) : 
+                   _doRootKeyboardEvent(_keyDownEventType, this, event);
         }
 
         if (event.type == ALLEGRO_EVENT_KEY_UP) {
             return _dragAndDrop ? 
-                    _doDragKeyEvent("dragKeyUp", this, event, _prevMouseEvent) : 
-                    _doRootKeyboardEvent("keyUp", this, event);
+                    _doRootDragKeyEvent(_dragKeyUpEventType, this, event, _prevMouseEvent) : 
+                    _doRootKeyboardEvent(_keyUpEventType, this, event);
         }
 
         if (event.type == ALLEGRO_EVENT_KEY_CHAR) {
             return _dragAndDrop ? 
-                   _doDragKeyEvent("dragKeyChar", this, event, _prevMouseEvent) :
-                   _doRootKeyboardEvent("keyChar", this, event);
+                   _doRootDragKeyEvent(_dragKeyCharEventType, this, event, _prevMouseEvent) :
+                   _doRootKeyboardEvent(_keyCharEventType, this, event);
         }
 
         if (event.type == ALLEGRO_EVENT_TIMER) {
-            Event event("timer");
+            Event event(_timerEventType);
             return _doTimerEvent(this, event);
         }
 
@@ -449,150 +680,116 @@ namespace algui {
     }
 
 
-    void InteractiveUINode::_setEnabledTree(UINode* node, bool parentEnabledTree) {
-        bool enabledTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            enabledTree = ((inode->m_flags & ENABLED) == ENABLED) && parentEnabledTree;
-        }
-        else {
-            enabledTree = parentEnabledTree;
-        }
-        if (node && enabledTree != node->isEnabledTree()) {
-            node->UINode::_setEnabledTree(enabledTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setEnabledTree(child, enabledTree);
+    const EventType& InteractiveUINode::_getDelegatedEventType(const EventType& type) {
+        return _getDelegatedEventTypeOf(type);
+    }
+
+
+    void InteractiveUINode::_dispatchFocusEvent(const EventType& type) {
+        std::optional<ObjectEvent<InteractiveUINode>> event;
+        for (InteractiveUINode* inode = this; inode; inode = inode->getParentPtr()) {
+            if (inode->hasEventListeners(type)) {
+                if (!event) {
+                    event.emplace(type, sharedFromThis<InteractiveUINode>());
+                }
+                inode->dispatchEvent(*event);
             }
         }
     }
 
 
+    void InteractiveUINode::_setEnabledTree(UINode* node, bool parentEnabledTree) {
+        _setTreeState(node, parentEnabledTree,
+            [](InteractiveUINode* inode, bool parentValue) { return ((inode->m_flags & ENABLED) == ENABLED) && parentValue; },
+            [](UINode* node) { return node->isEnabledTree(); },
+            [](UINode* node, bool v) { node->UINode::_setEnabledTree(v); });
+    }
+
+
     void InteractiveUINode::_setFocusedTree(UINode* node, bool parentFocusedTree) {
-        bool focusedTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            focusedTree = inode->isFocused() || parentFocusedTree;
-        }
-        else {
-            focusedTree = parentFocusedTree;
-        }
-        if (node && focusedTree != node->isFocusedTree()) {
-            node->UINode::_setFocusedTree(focusedTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setFocusedTree(child, focusedTree);
-            }
-        }
+        _setTreeState(node, parentFocusedTree,
+            [](InteractiveUINode* inode, bool parentValue) { return inode->isFocused() || parentValue; },
+            [](UINode* node) { return node->isFocusedTree(); },
+            [](UINode* node, bool v) { node->UINode::_setFocusedTree(v); });
     }
 
 
     void InteractiveUINode::_setHighlightedTree(UINode* node, bool parentHighlightedTree) {
-        bool highlightedTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            highlightedTree = inode->isHighlighted() || parentHighlightedTree;
-        }
-        else {
-            highlightedTree = parentHighlightedTree;
-        }
-        if (node && highlightedTree != node->isHighlightedTree()) {
-            node->UINode::_setHighlightedTree(highlightedTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setHighlightedTree(child, highlightedTree);
-            }
-        }
+        _setTreeState(node, parentHighlightedTree,
+            [](InteractiveUINode* inode, bool parentValue) { return inode->isHighlighted() || parentValue; },
+            [](UINode* node) { return node->isHighlightedTree(); },
+            [](UINode* node, bool v) { node->UINode::_setHighlightedTree(v); });
     }
 
 
     void InteractiveUINode::_setPressedTree(UINode* node, bool parentPressedTree) {
-        bool pressedTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            pressedTree = inode->isPressed() || parentPressedTree;
-        }
-        else {
-            pressedTree = parentPressedTree;
-        }
-        if (node && pressedTree != node->isPressedTree()) {
-            node->UINode::_setPressedTree(pressedTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setPressedTree(child, pressedTree);
-            }
-        }
+        _setTreeState(node, parentPressedTree,
+            [](InteractiveUINode* inode, bool parentValue) { return inode->isPressed() || parentValue; },
+            [](UINode* node) { return node->isPressedTree(); },
+            [](UINode* node, bool v) { node->UINode::_setPressedTree(v); });
     }
 
 
     void InteractiveUINode::_setSelectedTree(UINode* node, bool parentSelectedTree) {
-        bool selectedTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            selectedTree = inode->isSelected() || parentSelectedTree;
-        }
-        else {
-            selectedTree = parentSelectedTree;
-        }
-        if (node && selectedTree != node->isSelectedTree()) {
-            node->UINode::_setSelectedTree(selectedTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setSelectedTree(child, selectedTree);
-            }
-        }
+        _setTreeState(node, parentSelectedTree,
+            [](InteractiveUINode* inode, bool parentValue) { return inode->isSelected() || parentValue; },
+            [](UINode* node) { return node->isSelectedTree(); },
+            [](UINode* node, bool v) { node->UINode::_setSelectedTree(v); });
     }
 
 
     void InteractiveUINode::_setErrorTree(UINode* node, bool parentErrorTree) {
-        bool errorTree;
-        InteractiveUINode* inode = dynamic_cast<InteractiveUINode*>(node);
-        if (inode) {
-            errorTree = inode->isError() || parentErrorTree;
-        }
-        else {
-            errorTree = parentErrorTree;
-        }
-        if (node && errorTree != node->isErrorTree()) {
-            node->UINode::_setErrorTree(errorTree);
-            for (UINode* child = node->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                _setErrorTree(child, errorTree);
-            }
-        }
+        _setTreeState(node, parentErrorTree,
+            [](InteractiveUINode* inode, bool parentValue) { return inode->isError() || parentValue; },
+            [](UINode* node) { return node->isErrorTree(); },
+            [](UINode* node, bool v) { node->UINode::_setErrorTree(v); });
     }
 
 
-    bool InteractiveUINode::_doRootMouseMoveEvent(const std::string_view& type, const std::string_view& enterType, const std::string_view& leaveType, UINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doRootMouseMoveEvent(const EventType& type, const EventType& enterType, const EventType& leaveType, UINode* node, const ALLEGRO_EVENT& event) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
+        _EventPath path(type, node);
+        _EventPath enterPath(enterType, node);
+        _EventPath leavePath(leaveType, node);
         const bool hadMouse = node->intersects(_prevMouseEvent.mouse.x, _prevMouseEvent.mouse.y);
         const bool hasMouse = node->intersects(event.mouse.x, event.mouse.y);
         if (hadMouse && hasMouse) {
-            return _doMouseMoveEvent(type, enterType, leaveType, node, event);
+            return _doMouseMoveEvent(node, event, path, enterPath, leavePath);
         }
         if (hadMouse) {
-            return _doMouseLeaveEvent(leaveType, node, event);
+            return _doMouseLeaveEvent(node, event, leavePath);
         }
         if (hasMouse) {
-            return _doMouseEnterEvent(enterType, node, event);
+            return _doMouseEnterEvent(node, event, enterPath);
         }
         return false;
     }
 
 
-    bool InteractiveUINode::_doMouseEnterEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doMouseEnterEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
 
+        path.enter(node);
+        if (!path.hasEventListenersInTree(node)) {
+            return false;
+        }
+
         InteractiveUINode* inode = node->as<InteractiveUINode>();
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, true))) {
+        if (path.dispatchMouseEvent(inode, event, true)) {
             return true;
         }
 
         UINode* child = node->getChildAt(event.mouse.x, event.mouse.y);
-        if (_doMouseEnterEvent(type, child, event)) {
+        if (_doMouseEnterEvent(child, event, path)) {
             return true;
         }
         
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, false))) {
+        if (path.dispatchMouseEvent(inode, event, false)) {
             return true;
         }
 
@@ -600,14 +797,21 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doMouseMoveEvent(const std::string_view& type, const std::string_view& enterType, const std::string_view& leaveType, UINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doMouseMoveEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path, _EventPath& enterPath, _EventPath& leavePath) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
 
+        path.enter(node);
+        enterPath.enter(node);
+        leavePath.enter(node);
+        if (!path.hasEventListenersInTree(node) && !enterPath.hasEventListenersInTree(node) && !leavePath.hasEventListenersInTree(node)) {
+            return false;
+        }
+
         InteractiveUINode* inode = node->as<InteractiveUINode>();
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, true))) {
+        if (path.dispatchMouseEvent(inode, event, true)) {
             return true;
         }
 
@@ -615,19 +819,19 @@ namespace algui {
         UINode* newChild = node->getChildAt(event.mouse.x, event.mouse.y);
 
         if (oldChild == newChild) {
-            if (_doMouseMoveEvent(type, enterType, leaveType, newChild, event)) {
+            if (_doMouseMoveEvent(newChild, event, path, enterPath, leavePath)) {
                 return true;
             }
         }
         else {
-            const bool result1 = _doMouseLeaveEvent(leaveType, oldChild, _prevMouseEvent);
-            const bool result2 = _doMouseEnterEvent(enterType, newChild, event);
+            const bool result1 = _doMouseLeaveEvent(oldChild, _prevMouseEvent, leavePath);
+            const bool result2 = _doMouseEnterEvent(newChild, event, enterPath);
             if (result1 || result2) {
                 return true;
             }
         }
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, false))) {
+        if (path.dispatchMouseEvent(inode, event, false)) {
             return true;
         }
 
@@ -635,23 +839,28 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doMouseLeaveEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doMouseLeaveEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
 
+        path.enter(node);
+        if (!path.hasEventListenersInTree(node)) {
+            return false;
+        }
+
         InteractiveUINode* inode = node->as<InteractiveUINode>();
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, true))) {
+        if (path.dispatchMouseEvent(inode, event, true)) {
             return true;
         }
 
         UINode* child = node->getChildAt(_prevMouseEvent.mouse.x, _prevMouseEvent.mouse.y);
-        if (_doMouseLeaveEvent(type, child, _prevMouseEvent)) {
+        if (_doMouseLeaveEvent(child, _prevMouseEvent, path)) {
             return true;
         }
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, false))) {
+        if (path.dispatchMouseEvent(inode, event, false)) {
             return true;
         }
 
@@ -659,23 +868,34 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doMouseButtonEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doRootMouseButtonEvent(const EventType& type, UINode* node, const ALLEGRO_EVENT& event) {
+        _EventPath path(type, node);
+        return _doMouseButtonEvent(node, event, path);
+    }
+
+
+    bool InteractiveUINode::_doMouseButtonEvent(UINode* node, const ALLEGRO_EVENT& event, _EventPath& path) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
 
+        path.enter(node);
+        if (!path.hasEventListenersInTree(node)) {
+            return false;
+        }
+
         InteractiveUINode* inode = node->as<InteractiveUINode>();
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, true))) {
+        if (path.dispatchMouseEvent(inode, event, true)) {
             return true;
         }
 
         UINode* child = node->getChildAt(event.mouse.x, event.mouse.y);
-        if (_doMouseButtonEvent(type, child, event)) {
+        if (_doMouseButtonEvent(child, event, path)) {
             return true;
         }
 
-        if (_dispatchEvent(inode, MouseEvent(type, event.mouse.x, event.mouse.y, event.mouse.z, event.mouse.w, event.mouse.button, false))) {
+        if (path.dispatchMouseEvent(inode, event, false)) {
             return true;
         }
 
@@ -683,7 +903,7 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doRootKeyboardEvent(const std::string_view& type, InteractiveUINode* node, const ALLEGRO_EVENT& event) {
+    bool InteractiveUINode::_doRootKeyboardEvent(const EventType& type, InteractiveUINode* node, const ALLEGRO_EVENT& event) {
         if (!node->isEnabledTree()) {
             return false;
         }
@@ -691,7 +911,8 @@ namespace algui {
         KeyboardEvent keyEvent(type, event.keyboard.keycode, event.keyboard.unichar, event.keyboard.modifiers, event.keyboard.repeat);
 
         if (_focusedNode) {
-            if (_focusedNode->dispatchEvent(keyEvent)) {
+            _EventPath path(type, _focusedNode);
+            if (path.dispatchEvent(_focusedNode, keyEvent)) {
                 return true;
             }
         }
@@ -700,19 +921,24 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doKeyboardEvent(const std::string_view& type, UINode* node, const KeyboardEvent& event) {
-        if (!node || !node->isEnabledTree()) {
+    //pre-order walk; disabled subtrees and subtrees without listeners are skipped
+    bool InteractiveUINode::_doKeyboardEvent(const EventType& type, UINode* node, const KeyboardEvent& event) {
+        if (!node) {
             return false;
         }
 
-        InteractiveUINode* inode = node->as<InteractiveUINode>();
-
-        if (_dispatchEvent(inode, event)) {
-            return true;
-        }
-
-        for (UINode* child = node->UINode::getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-            if (_doKeyboardEvent(type, child, event)) {
+        _EventPath path(type, node);
+        const auto range = node->getPreorderRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            if (!it->isEnabledTree()) {
+                it.skipChildren();
+                continue;
+            }
+            path.enter(&*it);
+            if (!path.hasEventListenersInTree(&*it)) {
+                it.skipChildren();
+            }
+            else if (path.dispatchEvent(it->as<InteractiveUINode>(), event)) {
                 return true;
             }
         }
@@ -721,17 +947,24 @@ namespace algui {
     }
 
 
+    //pre-order walk; disabled subtrees and subtrees without listeners are skipped
     bool InteractiveUINode::_doTimerEvent(UINode* node, const Event& event) {
-        if (!node || !node->isEnabledTree()) {
+        if (!node) {
             return false;
         }
 
-        if (node->dispatchEvent(event)) {
-            return true;
-        }
-
-        for (UINode* child = node->UINode::getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-            if (_doTimerEvent(child, event)) {
+        _EventPath path(event.getEventType(), node);
+        const auto range = node->getPreorderRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            if (!it->isEnabledTree()) {
+                it.skipChildren();
+                continue;
+            }
+            path.enter(&*it);
+            if (!path.hasEventListenersInTree(&*it)) {
+                it.skipChildren();
+            }
+            else if (it->dispatchEvent(event) || path.dispatchDelegatedEvent(it->as<InteractiveUINode>(), event)) {
                 return true;
             }
         }
@@ -740,25 +973,35 @@ namespace algui {
     }
 
 
-    bool InteractiveUINode::_doDragKeyEvent(const std::string_view& type, UINode* node, const ALLEGRO_EVENT& event, const ALLEGRO_EVENT& mouseEvent) {
+    bool InteractiveUINode::_doRootDragKeyEvent(const EventType& type, UINode* node, const ALLEGRO_EVENT& event, const ALLEGRO_EVENT& mouseEvent) {
+        KeyboardEvent keyEvent(type, event.keyboard.keycode, event.keyboard.unichar, event.keyboard.modifiers, event.keyboard.repeat);
+        _EventPath path(type, node);
+        return _doDragKeyEvent(node, keyEvent, mouseEvent, path);
+    }
+
+
+    bool InteractiveUINode::_doDragKeyEvent(UINode* node, const KeyboardEvent& event, const ALLEGRO_EVENT& mouseEvent, _EventPath& path) {
         if (!node || !node->isEnabledTree()) {
             return false;
         }
 
-        InteractiveUINode* inode = node->as<InteractiveUINode>();
+        path.enter(node);
+        if (!path.hasEventListenersInTree(node)) {
+            return false;
+        }
 
-        KeyboardEvent keyEvent(type, event.keyboard.keycode, event.keyboard.unichar, event.keyboard.modifiers, event.keyboard.repeat);
+        InteractiveUINode* inode = node->as<InteractiveUINode>();
 
-        if (_dispatchEvent(inode, keyEvent)) {
+        if (path.dispatchEvent(inode, event)) {
             return true;
         }
 
         UINode* child = node->getChildAt(mouseEvent.mouse.x, mouseEvent.mouse.y);
-        if (_doDragKeyEvent(type, child, event, mouseEvent)) {
+        if (_doDragKeyEvent(child, event, mouseEvent, path)) {
             return true;
         }
 
-        if (_dispatchEvent(inode, keyEvent)) {
+        if (path.dispatchEvent(inode, event)) {
             return true;
         }
 
@@ -0,0 +1,102 @@
+#include <stdexcept>
+#include "algui/PostedEventQueue.hpp"
+
+
+namespace algui {
+
+
+    PostedEventQueue::PostedEventQueue()
+        : m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+    }
+
+
+    PostedEventQueue::~PostedEventQueue() {
+        while (Node* node = _pop()) {
+            delete node;
+        }
+    }
+
+
+    void PostedEventQueue::post(std::weak_ptr<EventTarget> target, std::unique_ptr<Event> event) {
+        if (!event) {
+            throw std::invalid_argument("PostedEventQueue: post: event is null.");
+        }
+        Node* node = new Node;
+        node->target = std::move(target);
+        node->event = std::move(event);
+        _push(node);
+    }
+
+
+    void PostedEventQueue::setBatchSize(size_t size) {
+        if (size == 0) {
+            throw std::invalid_argument("PostedEventQueue: setBatchSize: size is 0.");
+        }
+        m_batchSize = size;
+    }
+
+
+    size_t PostedEventQueue::dispatchEvents(size_t maxCount) {
+        size_t count = 0;
+        for (; count < maxCount; ++count) {
+            std::unique_ptr<Node> node(_pop());
+            if (!node) {
+                break;
+            }
+            const std::shared_ptr<EventTarget> target = node->target.lock();
+            if (target) {
+                target->dispatchEvent(*node->event);
+            }
+        }
+        return count;
+    }
+
+
+    //Vyukov's intrusive MPSC queue: producers exchange the head, then link the previous head to the new node;
+    //the consumer follows the next links from the tail, with a stub node keeping the queue non-empty.
+    void PostedEventQueue::_push(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+
+    PostedEventQueue::Node* PostedEventQueue::_pop() {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next) {
+                return nullptr;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        //a producer might be between exchanging the head and linking the previous head;
+        //its node will be available at the next call
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        _push(&m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            return tail;
+        }
+
+        return nullptr;
+    }
+
+
+} //namespace algui
@@ -1,23 +1,54 @@
 #include <allegro5/allegro.h>
 #include "algui/Rect.hpp"
+#include "algui/DrawBatch.hpp"
 
 
 namespace algui {
 
 
+    static float _clippingOriginX = 0;
+    static float _clippingOriginY = 0;
+
+
     Rect Rect::getClippingRectangle() {
         int x, y, w, h;
         al_get_clipping_rectangle(&x, &y, &w, &h);
-        return { (float)x, (float)y, (float)(x + w), (float)(y + h) };
+        return { x + _clippingOriginX, y + _clippingOriginY, x + w + _clippingOriginX, y + h + _clippingOriginY };
     }
 
 
+    //batched drawing is flushed only if the clipping rectangle actually changes
     void Rect::setClippingRectangle() const {
-        al_set_clipping_rectangle(
-            (int)std::floor(left),
-            (int)std::floor(top),
-            std::max((int)std::ceil(right) - (int)std::floor(left), 0),
-            std::max((int)std::ceil(bottom) - (int)std::floor(top), 0));
+        const float l = left - _clippingOriginX;
+        const float t = top - _clippingOriginY;
+        const float r = right - _clippingOriginX;
+        const float b = bottom - _clippingOriginY;
+        const int x = (int)std::floor(l);
+        const int y = (int)std::floor(t);
+        const int w = std::max((int)std::ceil(r) - x, 0);
+        const int h = std::max((int)std::ceil(b) - y, 0);
+        int prevX, prevY, prevW, prevH;
+        al_get_clipping_rectangle(&prevX, &prevY, &prevW, &prevH);
+        if (x != prevX || y != prevY || w != prevW || h != prevH) {
+            DrawBatch::flush();
+            al_set_clipping_rectangle(x, y, w, h);
+        }
+    }
+
+
+    float Rect::getClippingOriginX() {
+        return _clippingOriginX;
+    }
+
+
+    float Rect::getClippingOriginY() {
+        return _clippingOriginY;
+    }
+
+
+    void Rect::setClippingOrigin(float x, float y) {
+        _clippingOriginX = x;
+        _clippingOriginY = y;
     }
 
 
@@ -0,0 +1,168 @@
+#include "algui/RenderCache.hpp"
+
+
+namespace algui {
+
+
+    static size_t _maxByteCount = RenderCache::DEFAULT_MAX_BYTE_COUNT;
+    static RenderCache::Statistics _statistics;
+
+
+    //least and most recently used entries
+    static RenderCache::Entry* _first = nullptr;
+    static RenderCache::Entry* _last = nullptr;
+
+
+    //bitmaps are assumed to be 32 bits per pixel
+    static size_t _getByteCount(int width, int height) {
+        return (size_t)width * (size_t)height * 4;
+    }
+
+
+    RenderCache::Entry::Entry()
+        : m_bitmap(nullptr)
+        , m_width(0)
+        , m_height(0)
+        , m_left(0)
+        , m_top(0)
+        , m_valid(false)
+        , m_locked(false)
+        , m_prev(nullptr)
+        , m_next(nullptr)
+    {
+    }
+
+
+    RenderCache::Entry::~Entry() {
+        RenderCache::_release(*this);
+    }
+
+
+    size_t RenderCache::getMaxByteCount() {
+        return _maxByteCount;
+    }
+
+
+    void RenderCache::setMaxByteCount(size_t count) {
+        _maxByteCount = count;
+        _evict(count);
+    }
+
+
+    RenderCache::Statistics RenderCache::getStatistics() {
+        return _statistics;
+    }
+
+
+    void RenderCache::resetStatistics() {
+        _statistics.hitCount = 0;
+        _statistics.missCount = 0;
+    }
+
+
+    void RenderCache::clear() {
+        _evict(0);
+    }
+
+
+    //a bitmap of the same size is reused; otherwise, it is replaced, if the new one fits in the budget
+    bool RenderCache::_acquire(Entry& entry, int width, int height) {
+        entry.m_valid = false;
+        if (entry.m_bitmap && entry.m_width == width && entry.m_height == height) {
+            _unlink(entry);
+            _link(entry);
+            return true;
+        }
+
+        _release(entry);
+        const size_t byteCount = _getByteCount(width, height);
+        if (width <= 0 || height <= 0 || byteCount > _maxByteCount) {
+            return false;
+        }
+        _evict(_maxByteCount - byteCount);
+        if (_statistics.byteCount + byteCount > _maxByteCount) {
+            return false;
+        }
+
+        entry.m_bitmap = al_create_bitmap(width, height);
+        if (!entry.m_bitmap) {
+            return false;
+        }
+        entry.m_width = width;
+        entry.m_height = height;
+        _link(entry);
+        ++_statistics.bitmapCount;
+        _statistics.byteCount += byteCount;
+        return true;
+    }
+
+
+    void RenderCache::_release(Entry& entry) {
+        if (entry.m_bitmap) {
+            _unlink(entry);
+            al_destroy_bitmap(entry.m_bitmap);
+            --_statistics.bitmapCount;
+            _statistics.byteCount -= _getByteCount(entry.m_width, entry.m_height);
+            entry.m_bitmap = nullptr;
+            entry.m_width = 0;
+            entry.m_height = 0;
+        }
+        entry.m_valid = false;
+    }
+
+
+    void RenderCache::_hit(Entry& entry) {
+        ++_statistics.hitCount;
+        _unlink(entry);
+        _link(entry);
+    }
+
+
+    void RenderCache::_miss() {
+        ++_statistics.missCount;
+    }
+
+
+    void RenderCache::_evict(size_t maxByteCount) {
+        for (Entry* entry = _first; entry && _statistics.byteCount > maxByteCount;) {
+            Entry* next = entry->m_next;
+            if (!entry->m_locked) {
+                _release(*entry);
+            }
+            entry = next;
+        }
+    }
+
+
+    void RenderCache::_link(Entry& entry) {
+        entry.m_prev = _last;
+        entry.m_next = nullptr;
+        if (_last) {
+            _last->m_next = &entry;
+        }
+        else {
+            _first = &entry;
+        }
+        _last = &entry;
+    }
+
+
+    void RenderCache::_unlink(Entry& entry) {
+        if (entry.m_prev) {
+            entry.m_prev->m_next = entry.m_next;
+        }
+        else {
+            _first = entry.m_next;
+        }
+        if (entry.m_next) {
+            entry.m_next->m_prev = entry.m_prev;
+        }
+        else {
+            _last = entry.m_prev;
+        }
+        entry.m_prev = nullptr;
+        entry.m_next = nullptr;
+    }
+
+
+} //namespace algui
@@ -0,0 +1,25 @@
+#include "algui/RenderSnapshot.hpp"
+
+
+namespace algui {
+
+
+    //ids start from 1, since 0 is the id of nodes that belong to no snapshot
+    static uint32_t _getNextRenderSnapshotId() {
+        static uint32_t nextId = 0;
+        if (++nextId == 0) {
+            ++nextId;
+        }
+        return nextId;
+    }
+
+
+    RenderSnapshot::RenderSnapshot()
+        : m_id(_getNextRenderSnapshotId())
+        , m_structureEpoch(0)
+        , m_geometryEpoch(0)
+    {
+    }
+
+
+} //namespace algui
@@ -0,0 +1,104 @@
+#include <cstdint>
+#include <algorithm>
+#include <new>
+#include "algui/UIArena.hpp"
+
+
+namespace algui {
+
+
+    UIArena::UIArena(size_t blockSize)
+        : m_storage(new Storage(blockSize))
+    {
+    }
+
+
+    UIArena::~UIArena() {
+        m_storage->release();
+    }
+
+
+    size_t UIArena::getAllocatedSize() const {
+        return m_storage->getAllocatedSize();
+    }
+
+
+    size_t UIArena::getBlockCount() const {
+        return m_storage->getBlockCount();
+    }
+
+
+    UIArena::Storage::Storage(size_t blockSize)
+        : m_blockSize(blockSize)
+    {
+    }
+
+
+    //freed memory of the same size is reused, if it is suitably aligned
+    void* UIArena::Storage::allocate(size_t size, size_t alignment) {
+        const auto freeList = m_freeLists.find(size);
+        if (freeList != m_freeLists.end() && freeList->second && reinterpret_cast<uintptr_t>(freeList->second) % alignment == 0) {
+            FreeEntry* entry = freeList->second;
+            freeList->second = entry->next;
+            m_allocatedSize += size;
+            ++m_allocationCount;
+            return entry;
+        }
+
+        size_t padding = (alignment - reinterpret_cast<uintptr_t>(m_current) % alignment) % alignment;
+
+        if (!m_current || padding + size > m_remaining) {
+            const size_t blockSize = std::max(m_blockSize, size + alignment);
+            m_blocks.emplace_back(new unsigned char[blockSize]);
+            m_current = m_blocks.back().get();
+            m_remaining = blockSize;
+            padding = (alignment - reinterpret_cast<uintptr_t>(m_current) % alignment) % alignment;
+        }
+
+        void* result = m_current + padding;
+        m_current += padding + size;
+        m_remaining -= padding + size;
+        m_allocatedSize += size;
+        ++m_allocationCount;
+        return result;
+    }
+
+
+    //memory that cannot hold a free entry is not reused;
+    //the last deallocation after the arena is destroyed releases the storage
+    void UIArena::Storage::deallocate(void* p, size_t size) {
+        m_allocatedSize -= size;
+        --m_allocationCount;
+        if (m_released) {
+            if (m_allocationCount == 0) {
+                delete this;
+            }
+            return;
+        }
+        if (size >= sizeof(FreeEntry) && reinterpret_cast<uintptr_t>(p) % alignof(FreeEntry) == 0) {
+            FreeEntry*& head = m_freeLists[size];
+            head = new (p) FreeEntry{ head };
+        }
+    }
+
+
+    //invoked by the arena destructor
+    void UIArena::Storage::release() {
+        m_released = true;
+        if (m_allocationCount == 0) {
+            delete this;
+        }
+    }
+
+
+    size_t UIArena::Storage::getAllocatedSize() const {
+        return m_allocatedSize;
+    }
+
+
+    size_t UIArena::Storage::getBlockCount() const {
+        return m_blocks.size();
+    }
+
+
+} //namespace algui
@@ -0,0 +1,103 @@
+#include <stdexcept>
+#include "algui/UICommandBuffer.hpp"
+
+
+namespace algui {
+
+
+    UICommandBuffer::UICommandBuffer() {
+    }
+
+
+    void UICommandBuffer::addChild(std::shared_ptr<UINode> parent, std::shared_ptr<UINode> child, std::shared_ptr<UINode> nextSibling) {
+        if (!parent) {
+            throw std::invalid_argument("UICommandBuffer: addChild: parent is null.");
+        }
+        if (!child) {
+            throw std::invalid_argument("UICommandBuffer: addChild: child is null.");
+        }
+        m_commands.push_back(Command{ CommandType::ADD_CHILD, std::move(parent), std::move(child), std::move(nextSibling), Rect(), false });
+    }
+
+
+    void UICommandBuffer::remove(std::shared_ptr<UINode> node) {
+        if (!node) {
+            throw std::invalid_argument("UICommandBuffer: remove: node is null.");
+        }
+        m_commands.push_back(Command{ CommandType::REMOVE, std::move(node), nullptr, nullptr, Rect(), false });
+    }
+
+
+    void UICommandBuffer::setRect(std::shared_ptr<UINode> node, const Rect& rect) {
+        if (!node) {
+            throw std::invalid_argument("UICommandBuffer: setRect: node is null.");
+        }
+        m_commands.push_back(Command{ CommandType::SET_RECT, std::move(node), nullptr, nullptr, rect, false });
+    }
+
+
+    void UICommandBuffer::setVisible(std::shared_ptr<UINode> node, bool v) {
+        if (!node) {
+            throw std::invalid_argument("UICommandBuffer: setVisible: node is null.");
+        }
+        m_commands.push_back(Command{ CommandType::SET_VISIBLE, std::move(node), nullptr, nullptr, Rect(), v });
+    }
+
+
+    void UICommandBuffer::clear() {
+        m_commands.clear();
+    }
+
+
+    //the commands are moved out of the buffer first, so that the buffer is empty even if a command throws
+    void UICommandBuffer::apply() {
+        std::vector<Command> commands;
+        commands.swap(m_commands);
+
+        std::vector<std::shared_ptr<UINode>> children;
+        for (size_t index = 0; index < commands.size();) {
+            Command& command = commands[index];
+            switch (command.type) {
+                case CommandType::ADD_CHILD: {
+                    //consecutive additions to the same position keep their order when added as one batch
+                    size_t end = index + 1;
+                    for (; end < commands.size(); ++end) {
+                        const Command& next = commands[end];
+                        if (next.type != CommandType::ADD_CHILD || next.node != command.node || next.nextSibling != command.nextSibling) {
+                            break;
+                        }
+                    }
+                    if (end - index == 1) {
+                        command.node->addChild(command.child, command.nextSibling);
+                    }
+                    else {
+                        children.clear();
+                        for (size_t i = index; i < end; ++i) {
+                            children.push_back(std::move(commands[i].child));
+                        }
+                        command.node->addChildren(children, command.nextSibling);
+                    }
+                    index = end;
+                    continue;
+                }
+
+                case CommandType::REMOVE:
+                    if (UINode* parent = command.node->getParentPtr()) {
+                        parent->removeChild(command.node);
+                    }
+                    break;
+
+                case CommandType::SET_RECT:
+                    command.node->setRect(command.rect);
+                    break;
+
+                case CommandType::SET_VISIBLE:
+                    command.node->setVisible(command.visible);
+                    break;
+            }
+            ++index;
+        }
+    }
+
+
+} //namespace algui
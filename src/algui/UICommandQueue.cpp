@@ -0,0 +1,44 @@
+#include <iterator>
+#include "algui/UICommandQueue.hpp"
+
+
+namespace algui {
+
+
+    UICommandQueue::UICommandQueue() {
+    }
+
+
+    void UICommandQueue::submit(UICommandBuffer buffer) {
+        if (buffer.isEmpty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_buffers.push_back(std::move(buffer));
+    }
+
+
+    //the buffers are applied outside of the lock, so that producers are not blocked by the application of commands
+    size_t UICommandQueue::applyCommands() {
+        std::vector<UICommandBuffer> buffers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            buffers.swap(m_buffers);
+        }
+
+        for (size_t index = 0; index < buffers.size(); ++index) {
+            try {
+                buffers[index].apply();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_buffers.insert(m_buffers.begin(), std::make_move_iterator(buffers.begin() + index + 1), std::make_move_iterator(buffers.end()));
+                throw;
+            }
+        }
+
+        return buffers.size();
+    }
+
+
+} //namespace algui
@@ -1,5 +1,7 @@
+#include <allegro5/allegro.h>
 #include "algui/UINode.hpp"
 #include "algui/ObjectEvent.hpp"
+#include "algui/DrawBatch.hpp"
 
 
 namespace algui {
@@ -19,15 +21,77 @@ namespace algui {
         PRESSED_TREE          = 1 << 10,
         SELECTED_TREE         = 1 << 11,
         ERROR_TREE            = 1 << 12,
-        GEOMETRY_MANAGED      = 1 << 13
+        GEOMETRY_MANAGED      = 1 << 13,
+        DEFERRED_CHANGE_EVENTS = 1 << 14,
+        PAINT_DIRTY           = 1 << 16,
+        DESCENDANT_PAINT_DIRTY = 1 << 17,
+        CACHE_DIRTY           = 1 << 18,
+        DISPLAY_LIST_DIRTY    = 1 << 19
     };
 
 
     static constexpr int DIRTY_FLAGS = RECT_DIRTY | DESCENTANT_RECT_DIRTY | LAYOUT_DIRTY | SCREEN_RECT_DIRTY | SCREEN_SCALING_DIRTY;
 
 
+    static const EventType _rectChangedEventType("rectChanged");
+    static const EventType _scalingChangedEventType("scalingChanged");
+    static const EventType _visibleChangedEventType("visibleChanged");
+    static const EventType _clippedChangedEventType("clippedChanged");
+    static const EventType _geometryManagedChangedEventType("geometryManagedChanged");
+
+
+    //state of a node entered by a render walk
+    struct _RenderState {
+        int flags;
+        bool painted;
+        bool restoreClipping;
+        Rect prevClipping;
+        Rect clipping;
+
+        //entry of the node and end of its subtree, for walks of render snapshots
+        uint32_t index;
+        uint32_t end;
+    };
+
+
+    //states of the nodes entered by the render walks in progress
+    static std::vector<_RenderState> _renderStates;
+
+
+    //current structure epoch; nodes whose subtree changed structurally are stamped with it,
+    //and it is advanced by each render snapshot build, so each snapshot can compare stamps with the epoch it was built in
+    static size_t _structureEpoch = 1;
+
+
+    //current geometry epoch; nodes whose screen geometry or the geometry of their descendants was invalidated are stamped with it,
+    //and it is advanced by each walk of a render snapshot
+    static size_t _geometryEpoch = 1;
+
+
+    //the screen area of the target bitmap that can be painted; the clipping rectangle is within the target bitmap,
+    //unless there is no target bitmap
+    static Rect _getViewport() {
+        Rect viewport = Rect::getClippingRectangle();
+        if (ALLEGRO_BITMAP* target = al_get_target_bitmap()) {
+            const Rect bounds = Rect::rect(Rect::getClippingOriginX(), Rect::getClippingOriginY(), (float)al_get_bitmap_width(target), (float)al_get_bitmap_height(target));
+            viewport = Rect::intersectionOf(viewport, bounds);
+        }
+        return viewport;
+    }
+
+
+    //nodes with queued change events; raw pointers are valid only while the weak pointers are not expired
+    static std::vector<std::pair<std::weak_ptr<SharedObject>, UINode*>> _changeEventQueue;
+
+
     UINode::UINode()
         : m_flags(VISIBLE | ENABLED_TREE | GEOMETRY_MANAGED)
+        , m_eventListenerMask(0)
+        , m_eventListenerMaskDirty(false)
+        , m_renderSnapshotId(0)
+        , m_renderSnapshotIndex(0)
+        , m_structureStamp(0)
+        , m_geometryStamp(0)
     {
     }
 
@@ -45,7 +109,7 @@ namespace algui {
             if (getParentPtr()) {
                 getParentPtr()->invalidateRect();
             }
-            dispatchEvent(ObjectEvent<UINode>("rectChanged", sharedFromThis<UINode>()));
+            dispatchChangeEvent<UINode>(_rectChangedEventType);
         }
     }
 
@@ -55,7 +119,7 @@ namespace algui {
         if (scaling != m_scaling) {
             m_scaling = scaling;
             invalidateScreenScaling();
-            dispatchEvent(ObjectEvent<UINode>("scalingChanged", sharedFromThis<UINode>()));
+            dispatchChangeEvent<UINode>(_scalingChangedEventType);
         }
     }
 
@@ -67,12 +131,22 @@ namespace algui {
 
     void UINode::setVisible(bool v) {
         if (v != isVisible()) {
+            if (v) {
+                invalidatePaint();
+            }
+            else {
+                _addDamage(m_screenRect);
+                if (getParentPtr()) {
+                    getParentPtr()->_setDescendantPaintDirty();
+                }
+            }
             m_flags = v ? m_flags | VISIBLE : m_flags & ~VISIBLE;
+            _setStructureDirty();
             if (getParentPtr()) {
                 getParentPtr()->invalidateRect();
                 getParentPtr()->invalidateLayout();
             }
-            dispatchEvent(ObjectEvent<UINode>("visibleChanged", sharedFromThis<UINode>()));
+            dispatchChangeEvent<UINode>(_visibleChangedEventType);
         }
     }
 
@@ -85,7 +159,9 @@ namespace algui {
     void UINode::setClipped(bool v) {
         if (v != isClipped()) {
             m_flags = v ? m_flags | CLIPPED : m_flags & ~CLIPPED;
-            dispatchEvent(ObjectEvent<UINode>("clippedChanged", sharedFromThis<UINode>()));
+            _setStructureDirty();
+            invalidatePaint();
+            dispatchChangeEvent<UINode>(_clippedChangedEventType);
         }
     }
        
@@ -132,20 +208,152 @@ namespace algui {
                 getParentPtr()->invalidateRect();
                 getParentPtr()->invalidateLayout();
             }
-            dispatchEvent(ObjectEvent<UINode>("geometryManagedChanged", sharedFromThis<UINode>()));
+            dispatchChangeEvent<UINode>(_geometryManagedChangedEventType);
+        }
+    }
+
+
+    bool UINode::isDeferredChangeEvents() const {
+        return (m_flags & DEFERRED_CHANGE_EVENTS) == DEFERRED_CHANGE_EVENTS;
+    }
+
+
+    void UINode::setDeferredChangeEvents(bool v) {
+        m_flags = v ? m_flags | DEFERRED_CHANGE_EVENTS : m_flags & ~DEFERRED_CHANGE_EVENTS;
+    }
+
+
+    void UINode::dispatchChangeEvents() {
+        std::vector<std::pair<std::weak_ptr<SharedObject>, UINode*>> queue;
+        while (!_changeEventQueue.empty()) {
+            queue.swap(_changeEventQueue);
+            for (const auto& [ptr, node] : queue) {
+                const std::shared_ptr<SharedObject> object = ptr.lock();
+                if (object) {
+                    node->_dispatchQueuedChangeEvents();
+                }
+            }
+            queue.clear();
+        }
+    }
+
+
+    bool UINode::isRenderSnapshotEnabled() const {
+        return m_renderSnapshot != nullptr;
+    }
+
+
+    void UINode::setRenderSnapshotEnabled(bool v) {
+        if (!v) {
+            m_renderSnapshot.reset();
+        }
+        else if (!m_renderSnapshot) {
+            m_renderSnapshot = std::make_unique<RenderSnapshot>();
+        }
+    }
+
+
+    bool UINode::isCached() const {
+        return m_renderCache != nullptr;
+    }
+
+
+    void UINode::setCached(bool v) {
+        if (!v) {
+            m_renderCache.reset();
+            _setStructureDirty();
+        }
+        else if (!m_renderCache) {
+            m_renderCache = std::make_unique<RenderCache::Entry>();
+            _setStructureDirty();
+        }
+    }
+
+
+    bool UINode::isDisplayListEnabled() const {
+        return m_displayList != nullptr;
+    }
+
+
+    void UINode::setDisplayListEnabled(bool v) {
+        if (!v) {
+            m_displayList.reset();
+        }
+        else if (!m_displayList) {
+            m_displayList = std::make_unique<DisplayList>();
+            m_flags |= DISPLAY_LIST_DIRTY;
         }
     }
 
 
     void UINode::render() {
+        dispatchChangeEvents();
         _updateRect();
-        _render(0);
+        if (m_renderSnapshot) {
+            _renderSnapshot(0, nullptr);
+        }
+        else {
+            _render(0);
+        }
+        DrawBatch::flush();
+    }
+
+
+    void UINode::renderDamaged() {
+        dispatchChangeEvents();
+        _updateRect();
+
+        //snapshot entries are validated before the damage update refreshes their screen rects
+        if (m_renderSnapshot && !_isRenderSnapshotValid()) {
+            _updateRenderSnapshot();
+        }
+
+        if (!m_damageRegion) {
+            m_damageRegion = std::make_unique<DamageRegion>();
+            _updateDamage(*m_damageRegion);
+            m_damageRegion->clear();
+            if (m_renderSnapshot) {
+                _renderSnapshot(0, nullptr);
+            }
+            else {
+                _render(0);
+            }
+            DrawBatch::flush();
+            return;
+        }
+
+        _updateDamage(*m_damageRegion);
+        for (const Rect& rect : m_damageRegion->getRects()) {
+            if (m_renderSnapshot) {
+                _renderSnapshot(0, &rect);
+            }
+            else {
+                _render(0, rect);
+            }
+        }
+        m_damageRegion->clear();
+        DrawBatch::flush();
+    }
+
+
+    void UINode::invalidatePaint() {
+        m_flags |= PAINT_DIRTY | CACHE_DIRTY | DISPLAY_LIST_DIRTY;
+        if (getParentPtr()) {
+            getParentPtr()->_setDescendantPaintDirty();
+        }
     }
 
 
     void UINode::render(const Rect& clipping) {
+        dispatchChangeEvents();
         _updateRect();
-        _render(0, clipping);
+        if (m_renderSnapshot) {
+            _renderSnapshot(0, &clipping);
+        }
+        else {
+            _render(0, clipping);
+        }
+        DrawBatch::flush();
     }
 
 
@@ -177,10 +385,50 @@ namespace algui {
         if (child->m_flags & (RECT_DIRTY | DESCENTANT_RECT_DIRTY)) {
             _setDescentantRectDirty();
         }
+        _addEventListenerMask(child->m_eventListenerMask);
+        if (child->m_eventListenerMaskDirty) {
+            _setEventListenerMaskDirty();
+        }
+        _setStructureDirty();
+        child->invalidatePaint();
+    }
+
+
+    void UINode::setRemovedChildState(const std::shared_ptr<UINode>& child) {
+        TreeNode<UINode>::setRemovedChildState(child);
+        if (child->m_eventListenerMask) {
+            _setEventListenerMaskDirty();
+        }
+        _setStructureDirty();
+        _setDescendantPaintDirty();
+        if (child->m_flags & VISIBLE) {
+            _addDamage(child->m_screenRect);
+        }
+    }
+
+
+    void UINode::setMovedChildState(const std::shared_ptr<UINode>& child) {
+        TreeNode<UINode>::setMovedChildState(child);
+        _setStructureDirty();
+        child->invalidatePaint();
+    }
+
+
+    void UINode::firstEventListenerAdded(size_t eventTypeId) {
+        TreeNode<UINode>::firstEventListenerAdded(eventTypeId);
+        _addEventListenerMask(EventType::getMask(eventTypeId));
+    }
+
+
+    void UINode::lastEventListenerRemoved(size_t eventTypeId) {
+        TreeNode<UINode>::lastEventListenerRemoved(eventTypeId);
+        _setEventListenerMaskDirty();
     }
 
 
     void UINode::invalidateRect() {
+        m_flags |= DISPLAY_LIST_DIRTY;
+        _setGeometryDirty();
         if (m_flags & RECT_DIRTY) {
             return;
         }
@@ -193,16 +441,28 @@ namespace algui {
 
     void UINode::invalidateLayout() {
         m_flags |= LAYOUT_DIRTY;
+        _setGeometryDirty();
+        if (getParentPtr()) {
+            getParentPtr()->_setDescendantPaintDirty();
+        }
     }
 
 
     void UINode::invalidateScreenRect() {
         m_flags |= SCREEN_RECT_DIRTY;
+        _setGeometryDirty();
+        if (getParentPtr()) {
+            getParentPtr()->_setDescendantPaintDirty();
+        }
     }
 
 
     void UINode::invalidateScreenScaling() {
-        m_flags |= SCREEN_SCALING_DIRTY;
+        m_flags |= SCREEN_SCALING_DIRTY | CACHE_DIRTY | DISPLAY_LIST_DIRTY;
+        _setGeometryDirty();
+        if (getParentPtr()) {
+            getParentPtr()->_setDescendantPaintDirty();
+        }
     }
 
 
@@ -250,111 +510,524 @@ namespace algui {
 
 
     void UINode::_updateRect() {
-        if (m_flags & DESCENTANT_RECT_DIRTY) {
-            for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                child->_updateRect();
+        //rects are updated children first; subtrees without dirty rects are skipped
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+            if (it.isEntering()) {
+                if ((node.m_flags & DESCENTANT_RECT_DIRTY) == 0) {
+                    it.skipChildren();
+                }
+            }
+            else {
+                node.m_flags &= ~DESCENTANT_RECT_DIRTY;
+                if (node.m_flags & RECT_DIRTY) {
+                    node.updateRect();
+                    node.m_flags &= ~RECT_DIRTY;
+                }
             }
-            m_flags &= ~DESCENTANT_RECT_DIRTY;
-        }
-        if (m_flags & RECT_DIRTY) {
-            updateRect();
-            m_flags &= ~RECT_DIRTY;
         }
     }
 
 
+    //the screen rects of a render snapshot are stale once its root is updated by a walk that does not belong to it
     void UINode::_updateScreenProps(int& flags) {
         m_flags |= flags;
         flags = m_flags & DIRTY_FLAGS;
+        if (flags && m_renderSnapshot) {
+            m_renderSnapshot->m_geometryEpoch = 0;
+        }
         updateScreenProperties();
     }
 
 
+    //render walks might be nested (e.g. from within paint()), so each walk uses only the states it pushed;
+    //nodes outside of the viewport are not painted, and their subtrees are skipped if they are bounded by them,
+    //i.e. if they are clipped or cached; children of unclipped nodes might be outside of their parents
     void UINode::_render(int flags) {
-        if (m_flags & VISIBLE) {
-            _updateScreenProps(flags);
-            if ((m_flags & CLIPPED) == 0) {
-                paint();
-                for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                    child->_render(flags);
+        const Rect viewport = _getViewport();
+        const size_t base = _renderStates.size();
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+
+            if (it.isLeaving()) {
+                const _RenderState state = _renderStates.back();
+                _renderStates.pop_back();
+                if (state.painted) {
+                    node.paintOverlay();
+                }
+                if (state.restoreClipping) {
+                    state.prevClipping.setClippingRectangle();
                 }
-                paintOverlay();
+                continue;
             }
-            else {
-                const Rect prevClipping = Rect::getClippingRectangle();
-                m_screenRect.setClippingRectangle();
-                paint();
-                for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                    child->_render(flags);
+
+            _RenderState state{};
+            if (node.m_flags & VISIBLE) {
+                const bool isRoot = _renderStates.size() == base;
+                state.flags = isRoot ? flags : _renderStates.back().flags;
+                node._updateScreenProps(state.flags);
+                const Rect& region = isRoot ? viewport : _renderStates.back().clipping;
+                const Rect visibleRect = Rect::intersectionOf(node.m_screenRect, region);
+                const bool bounded = (node.m_flags & CLIPPED) || node.m_renderCache;
+                state.clipping = bounded ? visibleRect : region;
+                //unbounded nodes outside of the viewport are not painted, but their children are visited,
+                //so their cache flag is cleared as if they were painted, for later invalidations of their children to reach cached ancestors
+                if (!visibleRect.isValid()) {
+                    if (bounded) {
+                        node._deferScreenProps(state.flags);
+                        it.skipChildren();
+                    }
+                    else {
+                        node.m_flags &= ~CACHE_DIRTY;
+                    }
+                    _renderStates.push_back(state);
+                    continue;
                 }
-                paintOverlay();
-                prevClipping.setClippingRectangle();
+                if (node.m_flags & CLIPPED) {
+                    state.restoreClipping = true;
+                    state.prevClipping = Rect::getClippingRectangle();
+                    node.m_screenRect.setClippingRectangle();
+                }
+                if (node.m_renderCache) {
+                    node._renderCached(state.flags);
+                    it.skipChildren();
+                }
+                else {
+                    state.painted = true;
+                    node.m_flags &= ~CACHE_DIRTY;
+                    node._paint();
+                }
+            }
+            else {
+                it.skipChildren();
             }
+            _renderStates.push_back(state);
         }
     }
 
 
+    //the root of the walk always sets the clipping rectangle, and descendants set it only if they are clipped;
+    //culling is the same as in the walk without a clipping rectangle, with the clipping rectangle as the viewport
     void UINode::_render(int flags, const Rect& clipping) {
-        if (m_flags & VISIBLE) {
-            if (((m_flags & CLIPPED) == 0)) {
-                Rect intersection = Rect::intersectionOf(m_screenRect, clipping);
-                if (intersection.isValid()) {
-                    _updateScreenProps(flags);
-                    const Rect prevClipping = Rect::getClippingRectangle();
-                    clipping.setClippingRectangle();
-                    paint();
-                    for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                        child->_render1(flags, intersection);
-                    }
-                    paintOverlay();
-                    prevClipping.setClippingRectangle();
+        const size_t base = _renderStates.size();
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+
+            if (it.isLeaving()) {
+                const _RenderState state = _renderStates.back();
+                _renderStates.pop_back();
+                if (state.painted) {
+                    node.paintOverlay();
+                }
+                if (state.restoreClipping) {
+                    state.prevClipping.setClippingRectangle();
+                }
+                continue;
+            }
+
+            _RenderState state{};
+            if (node.m_flags & VISIBLE) {
+                const bool isRoot = _renderStates.size() == base;
+                state.flags = isRoot ? flags : _renderStates.back().flags;
+                node._updateScreenProps(state.flags);
+                const Rect& region = isRoot ? clipping : _renderStates.back().clipping;
+                const Rect visibleRect = Rect::intersectionOf(node.m_screenRect, region);
+                const bool bounded = (node.m_flags & CLIPPED) || node.m_renderCache;
+                state.clipping = bounded ? visibleRect : region;
+                if (bounded && !visibleRect.isValid()) {
+                    node._deferScreenProps(state.flags);
+                    it.skipChildren();
+                    _renderStates.push_back(state);
+                    continue;
+                }
+                if (isRoot || (node.m_flags & CLIPPED)) {
+                    state.restoreClipping = true;
+                    state.prevClipping = Rect::getClippingRectangle();
+                    state.clipping.setClippingRectangle();
+                }
+                //unbounded nodes outside of the region are not painted, but their children might be inside it
+                if (!visibleRect.isValid()) {
+                    node.m_flags &= ~CACHE_DIRTY;
+                    _renderStates.push_back(state);
+                    continue;
+                }
+                if (node.m_renderCache) {
+                    node._renderCached(state.flags);
+                    it.skipChildren();
+                }
+                else {
+                    state.painted = true;
+                    node.m_flags &= ~CACHE_DIRTY;
+                    node._paint();
                 }
             }
             else {
-                Rect intersection = Rect::intersectionOf(m_screenRect, clipping);
-                if (intersection.isValid()) {
-                    _updateScreenProps(flags);
-                    const Rect prevClipping = Rect::getClippingRectangle();
-                    intersection.setClippingRectangle();
-                    paint();
-                    for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                        child->_render1(flags, intersection);
+                it.skipChildren();
+            }
+            _renderStates.push_back(state);
+        }
+    }
+
+
+    //entries are visited in pre-order, and left when the walk reaches the end of their subtree;
+    //clipping and culling are the same as in the walks of the tree, but they read the screen rects of the snapshot;
+    //the screen props of the nodes are updated only if the geometry of the tree changed since the last walk of the snapshot,
+    //so nodes are otherwise accessed only for painting
+    void UINode::_renderSnapshot(int flags, const Rect* clipping) {
+        if (!_isRenderSnapshotValid()) {
+            _updateRenderSnapshot();
+        }
+
+        const Rect viewport = clipping ? Rect() : _getViewport();
+
+        RenderSnapshot& snapshot = *m_renderSnapshot;
+        const bool geometryValid = flags == 0 && (m_flags & DIRTY_FLAGS) == 0 && m_geometryStamp < snapshot.m_geometryEpoch;
+        const size_t geometryEpoch = ++_geometryEpoch;
+        bool deferred = false;
+        const size_t base = _renderStates.size();
+        const uint32_t size = static_cast<uint32_t>(snapshot.m_nodes.size());
+        for (uint32_t index = 0;;) {
+            while (_renderStates.size() > base && _renderStates.back().end <= index) {
+                const _RenderState state = _renderStates.back();
+                _renderStates.pop_back();
+                if (state.painted) {
+                    snapshot.m_nodes[state.index]->paintOverlay();
+                }
+                if (state.restoreClipping) {
+                    state.prevClipping.setClippingRectangle();
+                }
+            }
+
+            if (index == size) {
+                break;
+            }
+
+            const uint8_t entryFlags = snapshot.m_flags[index];
+            if ((entryFlags & RenderSnapshot::VISIBLE) == 0) {
+                index = snapshot.m_subtreeEnds[index];
+                continue;
+            }
+
+            const bool isRoot = index == 0;
+            _RenderState state{};
+            UINode* node = snapshot.m_nodes[index];
+            state.flags = isRoot ? flags : _renderStates.back().flags;
+            if (!geometryValid) {
+                node->_updateScreenProps(state.flags);
+                snapshot.m_screenRects[index] = node->m_screenRect;
+            }
+            const Rect& screenRect = snapshot.m_screenRects[index];
+            state.index = index;
+            state.end = snapshot.m_subtreeEnds[index];
+            const bool clipped = (entryFlags & RenderSnapshot::CLIPPED) != 0;
+            const bool cached = (entryFlags & RenderSnapshot::CACHED) != 0;
+            const Rect& region = !isRoot ? _renderStates.back().clipping : clipping ? *clipping : viewport;
+            const Rect visibleRect = Rect::intersectionOf(screenRect, region);
+            const bool bounded = clipped || cached;
+            state.clipping = bounded ? visibleRect : region;
+            if (bounded && !visibleRect.isValid()) {
+                if (state.flags) {
+                    node->_deferScreenProps(state.flags);
+                    deferred = true;
+                }
+                index = state.end;
+                continue;
+            }
+            if ((clipping && isRoot) || clipped) {
+                state.restoreClipping = true;
+                state.prevClipping = Rect::getClippingRectangle();
+                (clipping ? state.clipping : screenRect).setClippingRectangle();
+            }
+            if (!visibleRect.isValid()) {
+                node->m_flags &= ~CACHE_DIRTY;
+                _renderStates.push_back(state);
+                ++index;
+                continue;
+            }
+            //the entries of a subtree painted into the cache are refreshed, as the walk skips them
+            if (cached) {
+                if (node->_renderCached(state.flags)) {
+                    for (uint32_t i = index + 1; i < state.end; ++i) {
+                        snapshot.m_screenRects[i] = snapshot.m_nodes[i]->m_screenRect;
                     }
-                    paintOverlay();
-                    prevClipping.setClippingRectangle();
                 }
+                _renderStates.push_back(state);
+                index = state.end;
+                continue;
+            }
+            state.painted = true;
+            node->m_flags &= ~CACHE_DIRTY;
+            node->_paint();
+            _renderStates.push_back(state);
+            ++index;
+        }
+
+        //screen props deferred to culled subtrees are not in the snapshot yet
+        if (!geometryValid) {
+            snapshot.m_geometryEpoch = deferred ? 0 : geometryEpoch;
+        }
+    }
+
+
+    //the bitmap is valid while nothing in the subtree was invalidated and the node kept its screen rect;
+    //subtrees are rendered into the bitmap in screen coordinates, translated to the screen position of the bitmap;
+    //returns true if the subtree was painted
+    bool UINode::_renderCached(int flags) {
+        RenderCache::Entry& entry = *m_renderCache;
+        if (entry.m_valid && flags == 0 && (m_flags & CACHE_DIRTY) == 0 && entry.m_screenRect == m_screenRect) {
+            RenderCache::_hit(entry);
+            DrawBatch::drawBitmap(entry.m_bitmap, (float)entry.m_left, (float)entry.m_top, 0);
+            return false;
+        }
+
+        RenderCache::_miss();
+        if (flags & SCREEN_SCALING_DIRTY) {
+            RenderCache::_release(entry);
+        }
+        m_flags &= ~CACHE_DIRTY;
+
+        const int left = (int)std::floor(m_screenRect.left);
+        const int top = (int)std::floor(m_screenRect.top);
+        const int width = (int)std::ceil(m_screenRect.right) - left;
+        const int height = (int)std::ceil(m_screenRect.bottom) - top;
+        //subtrees that do not fit in the cache are painted directly, clipped as if they were cached
+        if (!RenderCache::_acquire(entry, width, height)) {
+            const Rect prevClipping = Rect::getClippingRectangle();
+            Rect::intersectionOf(prevClipping, m_screenRect).setClippingRectangle();
+            _renderSubtree(flags);
+            prevClipping.setClippingRectangle();
+            return true;
+        }
+
+        DrawBatch::flush();
+        ALLEGRO_BITMAP* const prevTarget = al_get_target_bitmap();
+        ALLEGRO_TRANSFORM prevTransform;
+        al_copy_transform(&prevTransform, al_get_current_transform());
+        const float prevOriginX = Rect::getClippingOriginX();
+        const float prevOriginY = Rect::getClippingOriginY();
+        const Rect prevClipping = Rect::getClippingRectangle();
+        const bool held = al_is_bitmap_drawing_held();
+        if (held) {
+            al_hold_bitmap_drawing(false);
+        }
+
+        al_set_target_bitmap(entry.m_bitmap);
+        ALLEGRO_TRANSFORM transform;
+        al_identity_transform(&transform);
+        al_translate_transform(&transform, (float)-left, (float)-top);
+        al_use_transform(&transform);
+        Rect::setClippingOrigin((float)left, (float)top);
+        m_screenRect.setClippingRectangle();
+        al_clear_to_color(al_map_rgba(0, 0, 0, 0));
+
+        entry.m_locked = true;
+        _renderSubtree(flags);
+        DrawBatch::flush();
+        entry.m_locked = false;
+        entry.m_left = left;
+        entry.m_top = top;
+        entry.m_screenRect = m_screenRect;
+        entry.m_valid = true;
+
+        al_set_target_bitmap(prevTarget);
+        al_use_transform(&prevTransform);
+        Rect::setClippingOrigin(prevOriginX, prevOriginY);
+        prevClipping.setClippingRectangle();
+        if (held) {
+            al_hold_bitmap_drawing(true);
+        }
+        DrawBatch::drawBitmap(entry.m_bitmap, (float)left, (float)top, 0);
+        return true;
+    }
+
+
+    //children of nodes skipped by culling keep the flags they would have inherited, until they are rendered
+    void UINode::_deferScreenProps(int flags) {
+        if (flags) {
+            for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
+                child->m_flags |= flags;
             }
         }
     }
 
 
-    void UINode::_render1(int flags, const Rect& clipping) {
-        if (m_flags & VISIBLE) {
-            if (((m_flags & CLIPPED) == 0)) {
-                Rect intersection = Rect::intersectionOf(m_screenRect, clipping);
-                if (intersection.isValid()) {
-                    _updateScreenProps(flags);
-                    paint();
-                    for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                        child->_render1(flags, intersection);
+    void UINode::_renderSubtree(int flags) {
+        _paint();
+        for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
+            child->_render(flags);
+        }
+        paintOverlay();
+    }
+
+
+    //the display list is recorded again if the node was invalidated, or if its screen rect changed through its ancestors
+    void UINode::_paint() {
+        if (!m_displayList) {
+            paint();
+            return;
+        }
+        if ((m_flags & DISPLAY_LIST_DIRTY) || m_displayList->m_screenRect != m_screenRect) {
+            m_flags &= ~DISPLAY_LIST_DIRTY;
+            m_displayList->clear();
+            m_displayList->m_screenRect = m_screenRect;
+            paint();
+        }
+        m_displayList->replay();
+    }
+
+
+    //the snapshot is valid if the structure of the tree did not change after the snapshot was built;
+    //each snapshot compares the stamps with its own epoch, so nested snapshots do not invalidate each other
+    bool UINode::_isRenderSnapshotValid() const {
+        return !m_renderSnapshot->m_nodes.empty() && m_structureStamp < m_renderSnapshot->m_structureEpoch;
+    }
+
+
+    //the tree is walked in pre-order; subtrees that did not change since they were put in the snapshot
+    //are copied from it, instead of being walked.
+    void UINode::_updateRenderSnapshot() {
+        RenderSnapshot& snapshot = *m_renderSnapshot;
+        const uint32_t id = snapshot.m_id;
+        const size_t structureEpoch = snapshot.m_structureEpoch;
+        const size_t prevSize = snapshot.m_nodes.size();
+
+        std::vector<UINode*> nodes;
+        std::vector<Rect> screenRects;
+        std::vector<uint8_t> flags;
+        std::vector<uint32_t> subtreeEnds;
+        nodes.reserve(prevSize);
+        screenRects.reserve(prevSize);
+        flags.reserve(prevSize);
+        subtreeEnds.reserve(prevSize);
+
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+
+            if (it.isLeaving()) {
+                subtreeEnds[node.m_renderSnapshotIndex] = static_cast<uint32_t>(nodes.size());
+                continue;
+            }
+
+            const uint32_t index = static_cast<uint32_t>(nodes.size());
+            const uint32_t prevIndex = node.m_renderSnapshotIndex;
+
+            //copy an unchanged subtree
+            if (&node != this && node.m_structureStamp < structureEpoch && node.m_renderSnapshotId == id && prevIndex < prevSize && snapshot.m_nodes[prevIndex] == &node) {
+                const uint32_t prevEnd = snapshot.m_subtreeEnds[prevIndex];
+                for (uint32_t i = prevIndex; i < prevEnd; ++i) {
+                    nodes.push_back(snapshot.m_nodes[i]);
+                    screenRects.push_back(snapshot.m_screenRects[i]);
+                    flags.push_back(snapshot.m_flags[i]);
+                    subtreeEnds.push_back(snapshot.m_subtreeEnds[i] - prevIndex + index);
+                }
+                if (index != prevIndex) {
+                    for (uint32_t i = index; i < nodes.size(); ++i) {
+                        nodes[i]->m_renderSnapshotId = id;
+                        nodes[i]->m_renderSnapshotIndex = i;
                     }
-                    paintOverlay();
                 }
+                it.skipChildren();
+                continue;
             }
-            else {
-                Rect intersection = Rect::intersectionOf(m_screenRect, clipping);
-                if (intersection.isValid()) {
-                    _updateScreenProps(flags);
-                    const Rect prevClipping = Rect::getClippingRectangle();
-                    intersection.setClippingRectangle();
-                    paint();
-                    for (UINode* child = getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
-                        child->_render1(flags, intersection);
+
+            node.m_renderSnapshotId = id;
+            node.m_renderSnapshotIndex = index;
+            nodes.push_back(&node);
+            screenRects.push_back(node.m_screenRect);
+            flags.push_back((node.m_flags & VISIBLE ? RenderSnapshot::VISIBLE : 0) | (node.m_flags & CLIPPED ? RenderSnapshot::CLIPPED : 0) | (node.m_renderCache ? RenderSnapshot::CACHED : 0));
+            subtreeEnds.push_back(index + 1);
+        }
+
+        snapshot.m_nodes.swap(nodes);
+        snapshot.m_screenRects.swap(screenRects);
+        snapshot.m_flags.swap(flags);
+        snapshot.m_subtreeEnds.swap(subtreeEnds);
+        snapshot.m_structureEpoch = ++_structureEpoch;
+        snapshot.m_geometryEpoch = 0;
+    }
+
+
+    //the node and its ancestors are stamped with the current epoch; ancestors of a node already stamped with it
+    //are stamped too, because nodes are attached to parents that are stamped at the same time
+    void UINode::_setStructureDirty() {
+        for (UINode* node = this; node; node = node->getParentPtr()) {
+            if (node->m_structureStamp == _structureEpoch) {
+                break;
+            }
+            node->m_structureStamp = _structureEpoch;
+        }
+    }
+
+
+    //same as for structure stamps
+    void UINode::_setGeometryDirty() {
+        for (UINode* node = this; node; node = node->getParentPtr()) {
+            if (node->m_geometryStamp == _geometryEpoch) {
+                break;
+            }
+            node->m_geometryStamp = _geometryEpoch;
+        }
+    }
+
+
+    //visible subtrees are updated if they might contain dirty nodes; the screen rects of nodes that moved or are dirty are damaged,
+    //and the render snapshot entries of moved nodes are refreshed
+    void UINode::_updateDamage(DamageRegion& damageRegion) {
+        RenderSnapshot* snapshot = m_renderSnapshot.get();
+        const size_t base = _renderStates.size();
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+
+            if (it.isLeaving()) {
+                _renderStates.pop_back();
+                continue;
+            }
+
+            _RenderState state{};
+            state.flags = _renderStates.size() > base ? _renderStates.back().flags : 0;
+            if ((node.m_flags & VISIBLE) && (state.flags || (node.m_flags & (DIRTY_FLAGS | PAINT_DIRTY | DESCENDANT_PAINT_DIRTY)))) {
+                const Rect prevScreenRect = node.m_screenRect;
+                node._updateScreenProps(state.flags);
+                if (node.m_screenRect != prevScreenRect) {
+                    damageRegion.add(prevScreenRect);
+                    damageRegion.add(node.m_screenRect);
+                    if (snapshot && node.m_renderSnapshotId == snapshot->m_id && node.m_renderSnapshotIndex < snapshot->m_nodes.size() && snapshot->m_nodes[node.m_renderSnapshotIndex] == &node) {
+                        snapshot->m_screenRects[node.m_renderSnapshotIndex] = node.m_screenRect;
                     }
-                    paintOverlay();
-                    prevClipping.setClippingRectangle();
                 }
+                else if (node.m_flags & PAINT_DIRTY) {
+                    damageRegion.add(node.m_screenRect);
+                }
+                node.m_flags &= ~(PAINT_DIRTY | DESCENDANT_PAINT_DIRTY);
             }
+            else {
+                it.skipChildren();
+            }
+            _renderStates.push_back(state);
+        }
+    }
+
+
+    void UINode::_addDamage(const Rect& rect) {
+        UINode* root = getRootPtr();
+        if (root->m_damageRegion) {
+            root->m_damageRegion->add(rect);
+        }
+    }
+
+
+    //the cache flag is cleared by painting, independently of the paint flag, so the walk stops only at nodes that have both
+    void UINode::_setDescendantPaintDirty() {
+        for (UINode* node = this; node; node = node->getParentPtr()) {
+            if ((node->m_flags & (DESCENDANT_PAINT_DIRTY | CACHE_DIRTY)) == (DESCENDANT_PAINT_DIRTY | CACHE_DIRTY)) {
+                break;
+            }
+            node->m_flags |= DESCENDANT_PAINT_DIRTY | CACHE_DIRTY;
         }
     }
 
@@ -371,31 +1044,112 @@ namespace algui {
 
     void UINode::_setEnabledTree(bool v) {
         m_flags = v ? m_flags | ENABLED_TREE : m_flags & ~ENABLED_TREE;
+        invalidatePaint();
     }
 
 
     void UINode::_setFocusedTree(bool v) {
         m_flags = v ? m_flags | FOCUSED_TREE : m_flags & ~FOCUSED_TREE;
+        invalidatePaint();
     }
 
 
     void UINode::_setHighlightedTree(bool v) {
         m_flags = v ? m_flags | HIGHLIGHTED_TREE : m_flags & ~HIGHLIGHTED_TREE;
+        invalidatePaint();
     }
 
 
     void UINode::_setPressedTree(bool v) {
         m_flags = v ? m_flags | PRESSED_TREE : m_flags & ~PRESSED_TREE;
+        invalidatePaint();
     }
 
 
     void UINode::_setSelectedTree(bool v) {
         m_flags = v ? m_flags | SELECTED_TREE : m_flags & ~SELECTED_TREE;
+        invalidatePaint();
     }
 
 
     void UINode::_setErrorTree(bool v) {
         m_flags = v ? m_flags | ERROR_TREE : m_flags & ~ERROR_TREE;
+        invalidatePaint();
+    }
+
+
+    void UINode::_queueChangeEvent(const EventType& eventType, ChangeEventFunction function) {
+        for (const ChangeEvent& changeEvent : m_changeEvents) {
+            if (changeEvent.type == eventType) {
+                return;
+            }
+        }
+
+        //nodes not owned by shared pointers cannot be queued
+        std::weak_ptr<SharedObject> ptr = weak_from_this();
+        if (ptr.expired()) {
+            function(this, eventType);
+            return;
+        }
+
+        if (m_changeEvents.empty()) {
+            _changeEventQueue.emplace_back(std::move(ptr), this);
+        }
+        m_changeEvents.push_back(ChangeEvent{ eventType, function });
+    }
+
+
+    void UINode::_dispatchQueuedChangeEvents() {
+        std::vector<ChangeEvent> changeEvents;
+        changeEvents.swap(m_changeEvents);
+        for (const ChangeEvent& changeEvent : changeEvents) {
+            changeEvent.function(this, changeEvent.type);
+        }
+    }
+
+
+    //the mask of a node is a superset of the masks of its children;
+    //adding bits is propagated immediately, whereas removing bits is deferred until the mask is needed.
+    void UINode::_addEventListenerMask(uint64_t mask) {
+        for (UINode* node = this; node; node = node->getParentPtr()) {
+            if ((node->m_eventListenerMask & mask) == mask) {
+                break;
+            }
+            node->m_eventListenerMask |= mask;
+        }
+    }
+
+
+    void UINode::_setEventListenerMaskDirty() {
+        for (UINode* node = this; node; node = node->getParentPtr()) {
+            if (node->m_eventListenerMaskDirty) {
+                break;
+            }
+            node->m_eventListenerMaskDirty = true;
+        }
+    }
+
+
+    uint64_t UINode::_getEventListenerMask() const {
+        //dirty masks are recomputed children first; clean subtrees are skipped
+        const auto range = getTraversalRange();
+        for (auto it = range.begin(); it != range.end(); ++it) {
+            UINode& node = *it;
+            if (it.isEntering()) {
+                if (!node.m_eventListenerMaskDirty) {
+                    it.skipChildren();
+                }
+            }
+            else if (node.m_eventListenerMaskDirty) {
+                uint64_t mask = node.getEventListenerMask();
+                for (UINode* child = node.getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
+                    mask |= child->m_eventListenerMask;
+                }
+                node.m_eventListenerMask = mask;
+                node.m_eventListenerMaskDirty = false;
+            }
+        }
+        return m_eventListenerMask;
     }
 
 
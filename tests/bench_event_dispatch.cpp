@@ -0,0 +1,181 @@
+#include <map>
+#include <iterator>
+#include <list>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <functional>
+
+
+#include "algui/TreeNode.hpp"
+#include "algui/MouseEvent.hpp"
+
+
+using namespace algui;
+
+
+namespace bench {
+
+
+    //replica of the string-keyed listener table that EventTarget used before event type ids.
+    class StringKeyedListeners {
+    public:
+        void addEventListener(const std::string& type, std::function<bool(const Event&)>&& func) {
+            m_eventListenerFunctions[type].push_back(std::move(func));
+        }
+
+        bool dispatchEvent(const Event& event) const {
+            auto it = m_eventListenerFunctions.find(event.getType());
+            if (it != m_eventListenerFunctions.end()) {
+                for (const auto& func : it->second) {
+                    if (func(event)) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+    private:
+        std::map<std::string, std::list<std::function<bool(const Event&)>>, std::less<>> m_eventListenerFunctions;
+    };
+
+
+    //mouse event class without an event class tag; listeners receive it via dynamic_cast.
+    class UntaggedMouseEvent : public MouseEvent {
+    public:
+        UntaggedMouseEvent(const EventType& type) : MouseEvent(type, 0, 0, 0, 0, 0, false) {
+        }
+    };
+
+
+    class DispatchNode : public TreeNode<DispatchNode> {
+    public:
+        StringKeyedListeners stringKeyedListeners;
+    };
+
+
+    static const char* const _listenedTypes[] = { "mouseEnter", "mouseMove", "mouseLeave", "mouseButtonDown", "mouseButtonUp", "rectChanged" };
+
+
+    template <class F>
+    static double _measure(size_t dispatchCount, const F& func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / dispatchCount;
+    }
+
+
+}
+
+
+using namespace bench;
+
+
+void bench_event_dispatch() {
+    constexpr size_t branchCount = 100;
+    constexpr size_t leafCount = 99;
+    constexpr size_t repeatCount = 50;
+
+    size_t counter = 0;
+    const auto listener = [&](const Event&) { ++counter; return false; };
+
+    //build a tree of 1 + 100 + 100 * 99 = 10001 nodes
+    std::shared_ptr<DispatchNode> root = std::make_shared<DispatchNode>();
+    std::vector<DispatchNode*> nodes{ root.get() };
+    for (size_t i = 0; i < branchCount; ++i) {
+        std::shared_ptr<DispatchNode> branch = std::make_shared<DispatchNode>();
+        root->addChild(branch);
+        nodes.push_back(branch.get());
+        for (size_t j = 0; j < leafCount; ++j) {
+            std::shared_ptr<DispatchNode> leaf = std::make_shared<DispatchNode>();
+            branch->addChild(leaf);
+            nodes.push_back(leaf.get());
+        }
+    }
+
+    const size_t registrationCount = nodes.size() * std::size(_listenedTypes);
+
+    const double stringKeyedRegistrationTime = _measure(registrationCount, [&]() {
+        for (DispatchNode* node : nodes) {
+            for (const char* type : _listenedTypes) {
+                node->stringKeyedListeners.addEventListener(type, listener);
+            }
+        }
+    });
+
+    const std::vector<EventType> listenedEventTypes(std::begin(_listenedTypes), std::end(_listenedTypes));
+
+    const double eventTypeIdRegistrationTime = _measure(registrationCount, [&]() {
+        for (DispatchNode* node : nodes) {
+            for (const EventType& type : listenedEventTypes) {
+                node->addEventListener(type, listener);
+            }
+        }
+    });
+
+    //each node receives the event twice, for the capture and bubble phase
+    const size_t dispatchCount = nodes.size() * 2 * repeatCount;
+    const EventType mouseMoveEventType("mouseMove");
+    const Event event(mouseMoveEventType);
+
+    const double stringKeyedTime = _measure(dispatchCount, [&]() {
+        for (size_t i = 0; i < repeatCount; ++i) {
+            for (DispatchNode* node : nodes) {
+                node->stringKeyedListeners.dispatchEvent(event);
+                node->stringKeyedListeners.dispatchEvent(event);
+            }
+        }
+    });
+
+    const double eventTypeIdTime = _measure(dispatchCount, [&]() {
+        for (size_t i = 0; i < repeatCount; ++i) {
+            for (DispatchNode* node : nodes) {
+                node->dispatchEvent(event);
+                node->dispatchEvent(event);
+            }
+        }
+    });
+
+    std::cout << "event listener registration, " << nodes.size() << " nodes, " << registrationCount << " listeners\n";
+    std::cout << "    string-keyed listeners: " << stringKeyedRegistrationTime << " ns/listener\n";
+    std::cout << "    event type id listeners: " << eventTypeIdRegistrationTime << " ns/listener\n";
+    std::cout << "event dispatch, " << nodes.size() << " nodes, " << dispatchCount << " dispatches\n";
+    std::cout << "    string-keyed listeners: " << stringKeyedTime << " ns/dispatch\n";
+    std::cout << "    event type id listeners: " << eventTypeIdTime << " ns/dispatch\n";
+    std::cout << "    listener invocations: " << counter << '\n';
+
+    //typed listeners
+    const EventType typedEventType("benchTypedEvent");
+    const EventType untaggedEventType("benchUntaggedEvent");
+    for (DispatchNode* node : nodes) {
+        node->addEventListener(typedEventType, [&](const MouseEvent& event) { counter += event.getX(); return false; });
+        node->addEventListener(untaggedEventType, [&](const UntaggedMouseEvent& event) { counter += event.getX(); return false; });
+    }
+    const MouseEvent typedEvent(typedEventType, 1, 0, 0, 0, 0, false);
+    const UntaggedMouseEvent untaggedEvent(untaggedEventType);
+
+    const double dynamicCastTime = _measure(dispatchCount, [&]() {
+        for (size_t i = 0; i < repeatCount; ++i) {
+            for (DispatchNode* node : nodes) {
+                node->dispatchEvent(untaggedEvent);
+                node->dispatchEvent(untaggedEvent);
+            }
+        }
+    });
+
+    const double eventClassTagTime = _measure(dispatchCount, [&]() {
+        for (size_t i = 0; i < repeatCount; ++i) {
+            for (DispatchNode* node : nodes) {
+                node->dispatchEvent(typedEvent);
+                node->dispatchEvent(typedEvent);
+            }
+        }
+    });
+
+    std::cout << "typed event dispatch, " << nodes.size() << " nodes, " << dispatchCount << " dispatches\n";
+    std::cout << "    dynamic_cast: " << dynamicCastTime << " ns/dispatch\n";
+    std::cout << "    event class tag: " << eventClassTagTime << " ns/dispatch\n";
+}
@@ -0,0 +1,208 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <iostream>
+
+
+#include "algui/TreeNode.hpp"
+#include "algui/UIArena.hpp"
+#include "algui/InteractiveUINode.hpp"
+
+
+using namespace algui;
+
+
+namespace bench {
+
+
+    template <class F>
+    static double _measureMs(const F& func) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+
+    //builds a tree of 1 + branchCount * (1 + leafCount) nodes
+    template <class F>
+    static std::shared_ptr<InteractiveUINode> _buildTree(size_t branchCount, size_t leafCount, const F& make) {
+        std::shared_ptr<InteractiveUINode> root = make();
+        for (size_t i = 0; i < branchCount; ++i) {
+            std::shared_ptr<InteractiveUINode> branch = make();
+            root->addChild(branch);
+            for (size_t j = 0; j < leafCount; ++j) {
+                branch->addChild(make());
+            }
+        }
+        return root;
+    }
+
+
+    class StressNode : public TreeNode<StressNode> {
+    };
+
+
+}
+
+
+using namespace bench;
+
+
+void bench_tree() {
+    constexpr size_t branchCount = 100;
+    constexpr size_t leafCount = 499;
+    constexpr size_t nodeCount = 1 + branchCount * (1 + leafCount);
+
+    std::shared_ptr<InteractiveUINode> root;
+
+    const double makeSharedBuildTime = _measureMs([&]() {
+        root = _buildTree(branchCount, leafCount, []() { return std::make_shared<InteractiveUINode>(); });
+    });
+    const double makeSharedDestroyTime = _measureMs([&]() {
+        root.reset();
+    });
+
+    double arenaBuildTime, arenaDestroyTime;
+    {
+        UIArena arena;
+        arenaBuildTime = _measureMs([&]() {
+            root = _buildTree(branchCount, leafCount, [&]() { return arena.make<InteractiveUINode>(); });
+        });
+        arenaDestroyTime = _measureMs([&]() {
+            root.reset();
+        });
+    }
+
+    std::cout << "tree allocation, " << nodeCount << " nodes\n";
+    std::cout << "    make_shared: build " << makeSharedBuildTime << " ms, destroy " << makeSharedDestroyTime << " ms\n";
+    std::cout << "    UIArena: build " << arenaBuildTime << " ms, destroy " << arenaDestroyTime << " ms\n";
+
+    //stress: million-node flat and deep trees
+    constexpr size_t stressNodeCount = 1000000;
+    std::shared_ptr<StressNode> stressRoot;
+
+    const double flatBuildTime = _measureMs([&]() {
+        stressRoot = std::make_shared<StressNode>();
+        for (size_t i = 0; i < stressNodeCount; ++i) {
+            stressRoot->addChild(std::make_shared<StressNode>());
+        }
+    });
+    const double flatRemoveChildrenTime = _measureMs([&]() {
+        stressRoot->removeChildren();
+    });
+    for (size_t i = 0; i < stressNodeCount; ++i) {
+        stressRoot->addChild(std::make_shared<StressNode>());
+    }
+    const double flatDestroyTime = _measureMs([&]() {
+        stressRoot.reset();
+    });
+
+    //built bottom-up, so that adding a child does not walk the ancestors
+    const double deepBuildTime = _measureMs([&]() {
+        stressRoot = std::make_shared<StressNode>();
+        for (size_t i = 0; i < stressNodeCount; ++i) {
+            std::shared_ptr<StressNode> parent = std::make_shared<StressNode>();
+            parent->addChild(stressRoot);
+            stressRoot = std::move(parent);
+        }
+    });
+    const double deepDestroyTime = _measureMs([&]() {
+        stressRoot.reset();
+    });
+
+    std::cout << "tree stress, " << stressNodeCount << " nodes\n";
+    std::cout << "    flat: build " << flatBuildTime << " ms, removeChildren " << flatRemoveChildrenTime << " ms, destroy " << flatDestroyTime << " ms\n";
+    std::cout << "    deep: build " << deepBuildTime << " ms, destroy " << deepDestroyTime << " ms\n";
+
+    //child index: random access in a long list of children, with insertions in the middle
+    constexpr size_t listChildCount = 100000;
+    std::shared_ptr<StressNode> list = std::make_shared<StressNode>();
+    list->setChildIndexEnabled(true);
+    const double indexedBuildTime = _measureMs([&]() {
+        for (size_t i = 0; i < listChildCount; ++i) {
+            list->addChild(std::make_shared<StressNode>(), list->getChildCount() ? list->getChildAt(list->getChildCount() / 2) : nullptr);
+        }
+    });
+    size_t indexSum = 0;
+    const double indexedAccessTime = _measureMs([&]() {
+        for (size_t i = 0; i < listChildCount; ++i) {
+            indexSum += list->indexOf(list->getChildAt((i * 7919) % listChildCount));
+        }
+    });
+
+    std::cout << "child index, " << listChildCount << " children\n";
+    std::cout << "    insert in the middle: " << indexedBuildTime * 1000000 / listChildCount << " ns/child\n";
+    std::cout << "    getChildAt + indexOf: " << indexedAccessTime * 1000000 / listChildCount << " ns/child (" << indexSum % 10 << ")\n";
+
+    //batch insertion of list rows
+    constexpr size_t rowCount = 10000;
+    constexpr size_t rowRepeatCount = 20;
+    double addChildTime = 0, addChildrenTime = 0;
+    for (size_t repeat = 0; repeat < rowRepeatCount; ++repeat) {
+        std::vector<std::shared_ptr<UINode>> rows;
+        for (size_t i = 0; i < rowCount; ++i) {
+            rows.push_back(std::make_shared<InteractiveUINode>());
+        }
+        //the list is nested, as in a real screen, so that each addChild checks the ancestors
+        std::shared_ptr<InteractiveUINode> screen = std::make_shared<InteractiveUINode>();
+        std::shared_ptr<InteractiveUINode> rowList = screen;
+        for (size_t depth = 0; depth < 16; ++depth) {
+            std::shared_ptr<InteractiveUINode> panel = std::make_shared<InteractiveUINode>();
+            rowList->addChild(panel);
+            rowList = panel;
+        }
+        addChildTime += _measureMs([&]() {
+            for (const std::shared_ptr<UINode>& row : rows) {
+                rowList->addChild(row);
+            }
+        });
+        rowList->removeChildren();
+        addChildrenTime += _measureMs([&]() {
+            rowList->addChildren(rows);
+        });
+    }
+
+    std::cout << "batch insertion, " << rowCount << " rows, at depth 16\n";
+    std::cout << "    addChild: " << addChildTime / rowRepeatCount << " ms, addChildren: " << addChildrenTime / rowRepeatCount << " ms\n";
+
+    //rendering a screen of panels, most of which are outside of the clipping, with and without a render snapshot
+    constexpr size_t panelCount = 60;
+    constexpr size_t panelRowCount = 499;
+    constexpr size_t renderNodeCount = 1 + panelCount * (1 + panelRowCount);
+    constexpr size_t renderRepeatCount = 20;
+    std::shared_ptr<UINode> renderRoot = _buildTree(panelCount, panelRowCount, []() { return std::make_shared<InteractiveUINode>(); });
+    renderRoot->setRect(Rect::rect(0, 0, 6000, 10000));
+    size_t panelIndex = 0;
+    for (UINode* panel = renderRoot->getFirstChildPtr(); panel; panel = panel->getNextSiblingPtr(), ++panelIndex) {
+        panel->setRect(Rect::rect(float(panelIndex % 10) * 600, float(panelIndex / 10) * 1000, 600, 1000));
+        size_t rowIndex = 0;
+        for (UINode* row = panel->getFirstChildPtr(); row; row = row->getNextSiblingPtr(), ++rowIndex) {
+            row->setRect(Rect::rect(0, float(rowIndex) * 2, 600, 2));
+        }
+    }
+    const Rect renderClipping = Rect::rect(0, 0, 1200, 100);
+    renderRoot->render();
+    const double treeRenderTime = _measureMs([&]() {
+        for (size_t repeat = 0; repeat < renderRepeatCount; ++repeat) {
+            renderRoot->render(renderClipping);
+        }
+    });
+    renderRoot->setRenderSnapshotEnabled(true);
+    const double snapshotBuildTime = _measureMs([&]() {
+        renderRoot->render(renderClipping);
+    });
+    const double snapshotRenderTime = _measureMs([&]() {
+        for (size_t repeat = 0; repeat < renderRepeatCount; ++repeat) {
+            renderRoot->render(renderClipping);
+        }
+    });
+    const double snapshotUpdateTime = _measureMs([&]() {
+        renderRoot->getLastChildPtr()->getFirstChildPtr()->setVisible(false);
+        renderRoot->render(renderClipping);
+    });
+
+    std::cout << "render, " << renderNodeCount << " nodes, clipped to the top of 2 panels\n";
+    std::cout << "    tree: " << treeRenderTime / renderRepeatCount << " ms, snapshot: " << snapshotRenderTime / renderRepeatCount << " ms\n";
+    std::cout << "    snapshot build: " << snapshotBuildTime << " ms, update after a change: " << snapshotUpdateTime << " ms\n";
+}
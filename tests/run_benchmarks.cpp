@@ -0,0 +1,7 @@
+extern void bench_event_dispatch();
+extern void bench_tree();
+
+void run_benchmarks() {
+    bench_event_dispatch();
+    bench_tree();
+}
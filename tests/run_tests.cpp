@@ -1,5 +1,21 @@
 extern void test_tree();
+extern void test_events();
+extern void test_ui_events();
+extern void test_ui_render();
+extern void test_delegated_events();
+extern void test_posted_events();
+extern void test_ui_commands();
+extern void test_event_profiler();
+extern void test_ui_arena();
 
 void run_tests() {
     test_tree();
+    test_events();
+    test_ui_events();
+    test_ui_render();
+    test_delegated_events();
+    test_posted_events();
+    test_ui_commands();
+    test_event_profiler();
+    test_ui_arena();
 }
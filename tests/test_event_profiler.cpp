@@ -0,0 +1,65 @@
+#include <cassert>
+
+
+#include "algui/EventProfiler.hpp"
+
+
+using namespace algui;
+
+
+namespace test {
+
+
+    class ProfiledTarget : public EventTarget {
+    };
+
+
+}
+
+
+using namespace test;
+
+
+void test_event_profiler() {
+    const EventType profiledType1("testProfiledEvent1");
+    const EventType profiledType2("testProfiledEvent2");
+
+    ProfiledTarget target;
+    EventProfiler::reset();
+    EventProfiler::setEventListenerProfilingEnabled(true);
+    const auto id1 = target.addEventListener(profiledType1, [](const Event& event) { return false; });
+    const auto id2 = target.addEventListener(profiledType1, [](const Event& event) { return true; });
+    target.addEventListener(profiledType1, [](const Event& event) { return false; });
+    for (int i = 0; i < 3; ++i) {
+        target.dispatchEvent(Event(profiledType1));
+    }
+    target.dispatchEvent(Event(profiledType2));
+
+    EventProfile profile = EventProfiler::getProfile(true);
+    if constexpr (EventProfiler::isEnabled()) {
+        assert(profile.eventTypes.size() == 2);
+        assert(profile.eventTypes[0].eventType == profiledType1);
+        assert(profile.eventTypes[0].dispatchCount == 3);
+        assert(profile.eventTypes[0].listenerInvocationCount == 6);
+        assert(profile.eventTypes[0].maxTime <= profile.eventTypes[0].totalTime);
+        assert(profile.eventTypes[1].eventType == profiledType2);
+        assert(profile.eventTypes[1].dispatchCount == 1);
+        assert(profile.eventTypes[1].listenerInvocationCount == 0);
+        assert(profile.eventListeners.size() == 2);
+        for (const EventListenerProfile& listenerProfile : profile.eventListeners) {
+            assert(listenerProfile.id == id1 || listenerProfile.id == id2);
+            assert(listenerProfile.eventType == profiledType1);
+            assert(listenerProfile.invocationCount == 3);
+        }
+    }
+    else {
+        assert(profile.eventTypes.empty());
+        assert(profile.eventListeners.empty());
+    }
+
+    //the profile was reset
+    assert(EventProfiler::getProfile().eventTypes.empty());
+    EventProfiler::setEventListenerProfilingEnabled(false);
+    target.dispatchEvent(Event(profiledType1));
+    assert(EventProfiler::getProfile().eventListeners.empty());
+}
@@ -0,0 +1,143 @@
+#include <string>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include <type_traits>
+#include <typeinfo>
+
+
+#include "algui/EventTarget.hpp"
+#include "algui/MouseEvent.hpp"
+#include "algui/KeyboardEvent.hpp"
+#include "algui/ChildEvent.hpp"
+
+
+using namespace algui;
+
+
+namespace test {
+
+
+    class Target : public EventTarget {
+    };
+
+
+    class UntaggedMouseEvent : public MouseEvent {
+    public:
+        UntaggedMouseEvent(const EventType& type) : MouseEvent(type, 1, 2, 0, 0, 1, false) {
+        }
+    };
+
+
+}
+
+
+using namespace test;
+
+
+void test_events() {
+    assert(EventType("testEvent1") == EventType(std::string("testEvent1")));
+    assert(EventType("testEvent1") != EventType("testEvent2"));
+    assert(EventType("testEvent1").getName() == "testEvent1");
+    assert(EventType("testEvent1").getId() < EventType::getCount());
+
+    std::shared_ptr<Target> target = std::make_shared<Target>();
+    std::vector<int> calls;
+
+    EventTarget::EventListenerId id1 = target->addEventListener("testEvent1", [&](const Event& event) { calls.push_back(1); return false; });
+    target->addEventListener(std::string("testEvent1"), [&](const Event& event) { calls.push_back(2); return false; });
+    target->addEventListener(EventType("testEvent1"), [&](const Event& event) { calls.push_back(3); return false; }, true);
+    target->addEventListener("testEvent2", [&](const Event& event) { calls.push_back(4); return true; });
+
+    assert(!target->dispatchEvent(Event("testEvent1")));
+    assert((calls == std::vector<int>{ 3, 1, 2 }));
+
+    calls.clear();
+    assert(target->dispatchEvent(Event("testEvent2")));
+    assert((calls == std::vector<int>{ 4 }));
+
+    calls.clear();
+    assert(!target->dispatchEvent(Event("testEvent3")));
+    assert(calls.empty());
+
+    target->removeEventListener(id1);
+    assert(!target->dispatchEvent(Event("testEvent1")));
+    assert((calls == std::vector<int>{ 3, 2 }));
+
+    bool thrown = false;
+    try {
+        target->removeEventListener(id1);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    //listeners removed while dispatching are not invoked and are freed after dispatching
+    std::shared_ptr<Target> target2 = std::make_shared<Target>();
+    EventTarget::EventListenerId id6;
+    calls.clear();
+    EventTarget::EventListenerId id5 = target2->addEventListener("testEvent1", [&](const Event& event) { 
+        calls.push_back(5); 
+        target2->removeEventListener(id5);
+        target2->removeEventListener(id6);
+        return false; 
+    });
+    id6 = target2->addEventListener("testEvent1", [&](const Event& event) { calls.push_back(6); return false; });
+    assert(!target2->dispatchEvent(Event("testEvent1")));
+    assert((calls == std::vector<int>{ 5 }));
+    assert(!target2->dispatchEvent(Event("testEvent1")));
+    assert((calls == std::vector<int>{ 5 }));
+
+    //large functors are stored on the heap
+    std::string text(100, 'a');
+    std::vector<int> large(16, 1);
+    calls.clear();
+    target2->addEventListener("testEvent1", [&calls, text, large](const Event& event) { calls.push_back((int)(text.size() + large.size())); return true; });
+    assert(target2->dispatchEvent(Event("testEvent1")));
+    assert((calls == std::vector<int>{ 116 }));
+
+    //ids are small handles that become stale when their listener or target goes away
+    static_assert(std::is_trivially_copyable_v<EventTarget::EventListenerId>);
+    static_assert(sizeof(EventTarget::EventListenerId) == 8);
+    assert(!EventTarget::EventListenerId().isValid());
+    assert(!id1.isValid());
+    EventTarget::EventListenerId id7 = target2->addEventListener("testEvent2", [&](const Event& event) { return false; });
+    EventTarget::EventListenerId id7Copy = id7;
+    assert(id7.isValid() && id7Copy == id7);
+    target2.reset();
+    assert(!id7.isValid());
+
+    //ids added to another target are removed when that target is destroyed
+    std::shared_ptr<Target> observer = std::make_shared<Target>();
+    calls.clear();
+    observer->addEventListenerId(target->addEventListener("testEvent4", [&](const Event& event) { calls.push_back(8); return false; }));
+    observer->addEventListenerId(id7);
+    target->dispatchEvent(Event("testEvent4"));
+    observer.reset();
+    target->dispatchEvent(Event("testEvent4"));
+    assert((calls == std::vector<int>{ 8 }));
+
+    //typed listeners
+    static_assert(HasEventClassTag<MouseEvent>::value);
+    static_assert(HasEventClassTag<ChildEvent<Target>>::value);
+    static_assert(!HasEventClassTag<UntaggedMouseEvent>::value);
+    calls.clear();
+    target->addEventListener("testEvent5", [&](const MouseEvent& event) { calls.push_back(event.getX()); return false; });
+    target->addEventListener("testEvent5", [&](const UntaggedMouseEvent& event) { calls.push_back(event.getY()); return false; });
+    target->addEventListener("testEvent6", [&](const ObjectEvent<Target>& event) { calls.push_back(event.getObject() == target ? 9 : 0); return false; });
+    target->dispatchEvent(UntaggedMouseEvent("testEvent5"));
+    target->dispatchEvent(ChildEvent<Target>("testEvent6", std::shared_ptr<Target>(target), target));
+    assert((calls == std::vector<int>{ 1, 2, 9 }));
+    assert(MouseEvent("testEvent5", 0, 0, 0, 0, 0, false).isA(Event::eventClass));
+    assert(!MouseEvent("testEvent5", 0, 0, 0, 0, 0, false).isA(KeyboardEvent::eventClass));
+
+    thrown = false;
+    try {
+        target->dispatchEvent(KeyboardEvent("testEvent5", 0, 0, 0, false));
+    }
+    catch (const std::bad_cast&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
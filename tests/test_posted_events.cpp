@@ -0,0 +1,98 @@
+#include <vector>
+#include <thread>
+#include <memory>
+#include <cassert>
+
+
+#include "algui/PostedEventQueue.hpp"
+#include "algui/InteractiveUINode.hpp"
+
+
+using namespace algui;
+
+
+namespace test {
+
+
+    class PostedEvent : public Event {
+    public:
+        static constexpr EventClassTag<PostedEvent, Event> eventClass{};
+
+        int producer;
+        int index;
+
+        PostedEvent(const EventType& type, int producer, int index) : Event(type, eventClass), producer(producer), index(index) {
+        }
+    };
+
+
+}
+
+
+using namespace test;
+
+
+void test_posted_events() {
+    const EventType postedType("testPostedEvent");
+    constexpr int PRODUCER_COUNT = 4;
+    constexpr int EVENT_COUNT = 10000;
+
+    auto root = std::make_shared<InteractiveUINode>();
+    auto node = std::make_shared<InteractiveUINode>();
+    root->addChild(node);
+
+    //events from the same producer arrive in order
+    std::vector<int> counts(PRODUCER_COUNT, 0);
+    bool ordered = true;
+    node->addEventListener(postedType, [&](const PostedEvent& event) {
+        ordered = ordered && event.index == counts[event.producer];
+        ++counts[event.producer];
+        return false;
+    });
+
+    std::shared_ptr<PostedEventQueue> queue = root->getPostedEventQueue();
+    assert(queue == root->getPostedEventQueue());
+    queue->setBatchSize(100);
+    std::weak_ptr<EventTarget> target = node;
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < PRODUCER_COUNT; ++producer) {
+        producers.emplace_back([=]() {
+            for (int index = 0; index < EVENT_COUNT; ++index) {
+                queue->post<PostedEvent>(target, postedType, producer, index);
+            }
+        });
+    }
+
+    //events are dispatched in batches while producers are running
+    ALLEGRO_EVENT timerEvent{};
+    timerEvent.type = ALLEGRO_EVENT_TIMER;
+    size_t total = 0;
+    while (total < PRODUCER_COUNT * EVENT_COUNT) {
+        root->doEvent(timerEvent);
+        size_t sum = 0;
+        for (int count : counts) {
+            sum += count;
+        }
+        assert(sum - total <= 100);
+        total = sum;
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    assert(ordered);
+    assert(queue->dispatchEvents() == 0);
+
+    //events to destroyed targets are discarded
+    queue->post<PostedEvent>(target, postedType, 0, EVENT_COUNT);
+    root->removeChild(node);
+    node.reset();
+    assert(queue->dispatchEvents() == 1);
+    assert(counts[0] == EVENT_COUNT);
+
+    //events not dispatched are released with the queue
+    auto other = std::make_shared<InteractiveUINode>();
+    auto otherQueue = std::make_shared<PostedEventQueue>();
+    otherQueue->post<PostedEvent>(other, postedType, 0, 0);
+    otherQueue.reset();
+}
@@ -2,6 +2,12 @@
 #include <iostream>
 #include <cassert>
 #include <type_traits>
+#include <vector>
+#include <iterator>
+#include <stdexcept>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
 
 
 #include "algui/TreeNode.hpp"
@@ -22,6 +28,15 @@ namespace test {
     };
 
 
+    class IntrusiveTest : public TreeNode<IntrusiveTest, IntrusiveTreeLinkPolicy> {
+    public:
+        std::string id;
+
+        IntrusiveTest(const std::string& id = {}) : id(id) {
+        }
+    };
+
+
     template <class T>
     static void print_tree(const std::shared_ptr<T>& node, size_t depth = 0) {
         std::cout << std::string(depth * 4, ' ') << node->id << std::endl;
@@ -81,4 +96,368 @@ void test_tree() {
 
     std::cout << '\n';
     print_tree(node1);
+
+    //sibling links
+    node1->addChild(node11);
+    node1->addChild(node12);
+    node1->addChild(node111, node1->getFirstChild());
+    assert(node1->getFirstChild() == node111);
+    assert(node11->getPrevSibling() == node111);
+    assert(node12->getPrevSibling() == node11);
+    assert(!node111->getPrevSibling());
+    node1->removeChild(node1->getFirstChild());
+    assert(!node111->getParentPtr());
+    assert(node1->getFirstChild() == node11);
+    assert(!node11->getPrevSibling());
+    node1->removeChild(node1->getLastChild());
+    assert(node1->getLastChild() == node11);
+    assert(!node11->getNextSibling());
+
+    //removing all children emits one event
+    int childrenRemovedCount = 0;
+    node1->addChild(node12);
+    node1->addEventListener("childrenRemoved", [&](const Event&) { ++childrenRemovedCount; return false; });
+    node1->removeChildren();
+    assert(childrenRemovedCount == 1);
+    assert(!node1->getFirstChild() && !node1->getLastChild());
+    assert(!node11->getParentPtr() && !node12->getParentPtr() && !node12->getPrevSibling());
+
+    //children referenced elsewhere survive their parent
+    node1->addChild(node11);
+    node1->addChild(node12);
+    node1.reset();
+    assert(!node11->getParentPtr() && !node11->getNextSibling());
+    assert(!node12->getParentPtr() && !node12->getPrevSibling());
+
+    //destruction of long sibling chains and deep trees does not recurse
+    constexpr size_t nodeCount = 200000;
+    std::shared_ptr<Test> flat = std::make_shared<Test>();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        flat->addChild(std::make_shared<Test>());
+    }
+    flat.reset();
+    std::shared_ptr<Test> deep = std::make_shared<Test>();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        std::shared_ptr<Test> parent = std::make_shared<Test>();
+        parent->addChild(deep);
+        deep = parent;
+    }
+    deep.reset();
+
+    //intrusive links take one pointer, and the self references of nodes keep the shared pointer API
+    static_assert(sizeof(IntrusiveTreeLinkPolicy::Link<IntrusiveTest>) == sizeof(void*));
+    std::shared_ptr<IntrusiveTest> iroot = std::make_shared<IntrusiveTest>("root");
+    std::shared_ptr<IntrusiveTest> ichild1 = std::make_shared<IntrusiveTest>("child1");
+    std::shared_ptr<IntrusiveTest> ichild2 = std::make_shared<IntrusiveTest>("child2");
+    std::shared_ptr<IntrusiveTest> ichild3 = std::make_shared<IntrusiveTest>("child3");
+    iroot->addChild(ichild1);
+    iroot->addChild(ichild3);
+    iroot->addChild(ichild2, iroot->getLastChild());
+    assert(ichild1.use_count() == 2);
+    assert(iroot->getFirstChild() == ichild1 && iroot->getLastChild() == ichild3);
+    assert(ichild1->getNextSibling() == ichild2 && ichild2->getNextSibling() == ichild3 && !ichild3->getNextSibling());
+    assert(ichild3->getPrevSibling() == ichild2 && ichild2->getPrevSibling() == ichild1 && !ichild1->getPrevSibling());
+    assert(ichild2->getParent() == iroot && ichild2->getRoot() == iroot);
+    iroot->removeChild(iroot->getFirstChild());
+    assert(ichild1.use_count() == 1 && !ichild1->getParentPtr());
+    assert(iroot->getFirstChild() == ichild2 && !ichild2->getPrevSibling());
+    iroot->removeChild(ichild3);
+    assert(iroot->getLastChild() == ichild2 && !ichild2->getNextSibling());
+
+    //the tree owns nodes not referenced elsewhere
+    std::weak_ptr<IntrusiveTest> iorphan;
+    {
+        std::shared_ptr<IntrusiveTest> node = std::make_shared<IntrusiveTest>();
+        iorphan = node;
+        ichild2->addChild(node);
+    }
+    assert(!iorphan.expired() && ichild2->getFirstChildPtr() == iorphan.lock().get());
+    iroot.reset();
+    assert(!ichild2->getParentPtr() && ichild2.use_count() == 1);
+    ichild2.reset();
+    assert(iorphan.expired());
+
+    std::shared_ptr<IntrusiveTest> ideep = std::make_shared<IntrusiveTest>();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        std::shared_ptr<IntrusiveTest> parent = std::make_shared<IntrusiveTest>();
+        parent->addChild(ideep);
+        parent->addChild(std::make_shared<IntrusiveTest>());
+        ideep = parent;
+    }
+    ideep.reset();
+
+    //child count, child at index and index of child, with and without the child index
+    for (bool indexed : { false, true }) {
+        std::shared_ptr<Test> list = std::make_shared<Test>();
+        std::vector<std::shared_ptr<Test>> expected;
+        list->setChildIndexEnabled(indexed);
+        unsigned seed = 1;
+        auto random = [&](size_t n) { seed = seed * 1103515245 + 12345; return (seed >> 8) % n; };
+        for (size_t i = 0; i < 5000; ++i) {
+            if (expected.empty() || random(3) != 0) {
+                const size_t index = random(expected.size() + 1);
+                std::shared_ptr<Test> child = std::make_shared<Test>();
+                list->addChild(child, index < expected.size() ? expected[index] : nullptr);
+                expected.insert(expected.begin() + index, child);
+            }
+            else {
+                const size_t index = random(expected.size());
+                list->removeChild(expected[index]);
+                expected.erase(expected.begin() + index);
+            }
+            if (i == 2500) {
+                list->setChildIndexEnabled(!indexed);
+                list->setChildIndexEnabled(indexed);
+            }
+        }
+        assert(list->isChildIndexEnabled() == indexed);
+        assert(list->getChildCount() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            assert(list->getChildAt(i) == expected[i]);
+            assert(list->indexOf(expected[i]) == i);
+        }
+        bool thrown = false;
+        try {
+            list->getChildAt(expected.size());
+        }
+        catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        assert(thrown);
+        list->removeChildren();
+        assert(list->getChildCount() == 0);
+        list->addChild(expected[0]);
+        assert(list->getChildAt(0) == expected[0] && list->indexOf(expected[0]) == 0);
+    }
+
+    //batch insertion and removal
+    std::shared_ptr<Test> batch = std::make_shared<Test>();
+    batch->setChildIndexEnabled(true);
+    std::vector<std::shared_ptr<Test>> first{ std::make_shared<Test>("a"), std::make_shared<Test>("d") };
+    std::vector<std::shared_ptr<Test>> middle{ std::make_shared<Test>("b"), std::make_shared<Test>("c") };
+    int childrenAddedCount = 0;
+    size_t childrenRemovedSize = 0;
+    batch->addEventListener("childrenAdded", [&](const ChildrenEvent<Test>& e) { ++childrenAddedCount; return false; });
+    batch->addEventListener("childrenRemoved", [&](const ChildrenEvent<Test>& e) { childrenRemovedSize += e.getChildren().size(); return false; });
+    batch->addChildren(first);
+    batch->addChildren(middle, first[1]);
+    assert(childrenAddedCount == 2);
+    assert(batch->getChildCount() == 4);
+    const char* const order[] = { "a", "b", "c", "d" };
+    size_t position = 0;
+    for (Test* child = batch->getFirstChildPtr(); child; child = child->getNextSiblingPtr(), ++position) {
+        assert(child->id == order[position]);
+        assert(batch->getChildAt(position).get() == child && batch->indexOf(child) == position);
+        assert(child->getPrevSiblingPtr() == (position ? batch->getChildAt(position - 1).get() : nullptr));
+    }
+    assert(batch->getLastChild() == first[1]);
+
+    //a failed check adds no child
+    std::vector<std::shared_ptr<Test>> invalid{ std::make_shared<Test>("e"), std::make_shared<Test>("f"), middle[0] };
+    bool thrown = false;
+    try {
+        batch->addChildren(invalid);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && !invalid[0]->getParentPtr() && !invalid[1]->getParentPtr() && batch->getChildCount() == 4);
+    thrown = false;
+    try {
+        batch->addChildren({ invalid[0], invalid[0] });
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && !invalid[0]->getParentPtr());
+    thrown = false;
+    try {
+        middle[0]->addChildren({ batch });
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && !batch->getParentPtr());
+
+    batch->removeChildren({ middle[1], first[0] });
+    assert(childrenRemovedSize == 2);
+    assert(batch->getChildCount() == 2 && batch->getFirstChild() == middle[0] && batch->getLastChild() == first[1]);
+    assert(batch->indexOf(first[1]) == 1 && !first[0]->getParentPtr());
+    batch->removeChildren();
+    assert(childrenRemovedSize == 4);
+
+    //cached depth and root follow reparenting of subtrees
+    std::shared_ptr<Test> tree1 = std::make_shared<Test>("tree1");
+    std::shared_ptr<Test> tree2 = std::make_shared<Test>("tree2");
+    std::shared_ptr<Test> branch = std::make_shared<Test>("branch");
+    std::shared_ptr<Test> leaf = std::make_shared<Test>("leaf");
+    branch->addChild(leaf);
+    assert(leaf->getDepth() == 1 && leaf->getRootPtr() == branch.get());
+    tree1->addChild(std::make_shared<Test>());
+    tree1->getFirstChild()->addChild(branch);
+    assert(leaf->getDepth() == 3 && leaf->getRootPtr() == tree1.get() && branch->getDepth() == 2);
+    assert(tree1->contains(leaf) && branch->contains(leaf) && !leaf->contains(branch) && !tree2->contains(leaf));
+    tree1->getFirstChild()->removeChild(branch);
+    assert(leaf->getDepth() == 1 && leaf->getRoot() == branch && branch->getDepth() == 0);
+    assert(!tree1->contains(leaf));
+    tree2->addChildren({ branch });
+    assert(leaf->getDepth() == 2 && leaf->getRootPtr() == tree2.get());
+    thrown = false;
+    try {
+        leaf->addChild(tree2);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    tree2.reset();
+    assert(branch->getDepth() == 0 && leaf->getRootPtr() == branch.get() && leaf->getDepth() == 1);
+
+    //cached positions follow subtrees that are built bottom-up, then removed
+    std::shared_ptr<Test> row = std::make_shared<Test>("row");
+    row->addChild(std::make_shared<Test>("cell"));
+    row->getFirstChild()->addChild(std::make_shared<Test>("content"));
+    leaf->addChild(row);
+    assert(row->getFirstChild()->getFirstChild()->getDepth() == 4 && row->getFirstChild()->getFirstChild()->getRootPtr() == branch.get());
+    assert(branch->contains(row->getFirstChild()->getFirstChild()) && leaf->getDepth() == 1);
+    std::shared_ptr<Test> cell = row->getFirstChild();
+    row.reset();
+    leaf->removeChildren();
+    assert(cell->getDepth() == 0 && cell->getFirstChild()->getDepth() == 1 && cell->getFirstChild()->getRootPtr() == cell.get());
+
+    //removal invalidates the cached positions of removed subtrees without walking them, even if the old root is reattached or destroyed
+    std::shared_ptr<Test> oldRoot = std::make_shared<Test>("oldRoot");
+    std::shared_ptr<Test> removed = std::make_shared<Test>("removed");
+    std::shared_ptr<Test> kept = std::make_shared<Test>("kept");
+    oldRoot->addChildren({ removed, kept });
+    removed->addChild(std::make_shared<Test>("content"));
+    Test* content = removed->getFirstChildPtr();
+    assert(content->getDepth() == 2 && content->getRootPtr() == oldRoot.get() && kept->getDepth() == 1);
+    cell->addChild(oldRoot);
+    oldRoot->removeChild(removed);
+    cell->removeChild(oldRoot);
+    assert(kept->getDepth() == 1 && kept->getRootPtr() == oldRoot.get());
+    oldRoot->removeChild(kept);
+    oldRoot.reset();
+    assert(content->getDepth() == 1 && content->getRootPtr() == removed.get());
+    assert(kept->getDepth() == 0 && kept->getRootPtr() == kept.get());
+
+    //pre-order, post-order, ancestor and traversal iteration
+    std::shared_ptr<Test> a = std::make_shared<Test>("a");
+    std::shared_ptr<Test> b = std::make_shared<Test>("b");
+    std::shared_ptr<Test> c = std::make_shared<Test>("c");
+    std::shared_ptr<Test> d = std::make_shared<Test>("d");
+    std::shared_ptr<Test> e = std::make_shared<Test>("e");
+    a->addChildren({ b, e });
+    b->addChildren({ c, d });
+    std::string visited;
+    for (Test& node : a->getPreorderRange()) {
+        visited += node.id;
+    }
+    assert(visited == "abcde");
+    visited.clear();
+    for (Test& node : a->getPostorderRange()) {
+        visited += node.id;
+    }
+    assert(visited == "cdbea");
+    visited.clear();
+    for (Test& node : d->getAncestorRange()) {
+        visited += node.id;
+    }
+    assert(visited == "ba");
+    visited.clear();
+    for (Test& node : b->getPreorderRange()) {
+        visited += node.id;
+    }
+    assert(visited == "bcd");
+    visited.clear();
+    const auto preorder = a->getPreorderRange();
+    for (auto it = preorder.begin(); it != preorder.end(); ++it) {
+        visited += it->id;
+        if (it->id == "b") {
+            it.skipChildren();
+        }
+    }
+    assert(visited == "abe");
+    visited.clear();
+    const auto traversal = a->getTraversalRange();
+    for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+        visited += it.isEntering() ? it->id : "/" + it->id;
+        if (it.isEntering() && it->id == "c") {
+            it.skipChildren();
+        }
+    }
+    assert(visited == "abc/cd/d/be/e/a");
+    visited.clear();
+    std::shared_ptr<Test> f = std::make_shared<Test>("f");
+    d->addChild(f);
+    for (auto it = traversal.begin(); it != traversal.end(); ++it) {
+        visited += it.isEntering() ? it->id : "/" + it->id;
+        if (it.isLeaving()) {
+            it.skipChildren();
+        }
+    }
+    assert(visited == "abc/cdf/f/d/be/e/a");
+    d->removeChild(f);
+    visited.clear();
+    for (Test& node : c->getTraversalRange()) {
+        visited += node.id;
+    }
+    assert(visited == "cc");
+#if __cplusplus >= 202002L
+    static_assert(std::ranges::forward_range<decltype(a->getPreorderRange())>);
+    static_assert(std::ranges::forward_range<decltype(a->getTraversalRange())>);
+#endif
+
+    //iteration of very deep trees does not recurse
+    std::shared_ptr<Test> chain = std::make_shared<Test>();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        std::shared_ptr<Test> parent = std::make_shared<Test>();
+        parent->addChild(chain);
+        chain = parent;
+    }
+    const auto postorder = chain->getPostorderRange();
+    assert(size_t(std::distance(postorder.begin(), postorder.end())) == nodeCount + 1);
+
+    //moving children relinks them in place, with one event
+    std::shared_ptr<Test> windows = std::make_shared<Test>();
+    windows->setChildIndexEnabled(true);
+    std::vector<std::shared_ptr<Test>> window{ std::make_shared<Test>("1"), std::make_shared<Test>("2"), std::make_shared<Test>("3"), std::make_shared<Test>("4") };
+    windows->addChildren(window);
+    int addedOrRemovedCount = 0;
+    std::string movedIds;
+    windows->addEventListener("childAdded", [&](const Event&) { ++addedOrRemovedCount; return false; });
+    windows->addEventListener("childRemoved", [&](const Event&) { ++addedOrRemovedCount; return false; });
+    windows->addEventListener("childMoved", [&](const ChildEvent<Test>& e) { movedIds += e.getChild()->id; return false; });
+    auto getOrder = [&]() {
+        std::string result;
+        for (Test* child = windows->getFirstChildPtr(); child; child = child->getNextSiblingPtr()) {
+            result += child->id;
+            assert(windows->getChildAt(windows->indexOf(child)).get() == child);
+        }
+        for (Test* child = windows->getLastChildPtr(); child; child = child->getPrevSiblingPtr()) {
+            assert(result[windows->indexOf(child)] == child->id[0]);
+        }
+        return result;
+    };
+    window[1]->bringToFront();
+    assert(getOrder() == "1342");
+    window[1]->sendToBack();
+    assert(getOrder() == "2134");
+    windows->moveChild(windows->getLastChild(), windows->getFirstChild());
+    assert(getOrder() == "4213");
+    windows->moveChild(window[1], window[2]);
+    assert(getOrder() == "4123");
+    window[2]->bringToFront();
+    windows->moveChild(window[0], window[1]);
+    assert(getOrder() == "4123" && movedIds == "2242");
+    assert(addedOrRemovedCount == 0 && window[3]->getDepth() == 1 && windows->getChildCount() == 4);
+    thrown = false;
+    try {
+        windows->moveChild(d);
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
 }
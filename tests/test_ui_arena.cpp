@@ -0,0 +1,72 @@
+#include <vector>
+#include <array>
+#include <memory>
+#include <cassert>
+
+
+#include "algui/UIArena.hpp"
+#include "algui/InteractiveUINode.hpp"
+
+
+using namespace algui;
+
+
+void test_ui_arena() {
+    std::vector<InteractiveUINode*> nodes;
+    {
+        //the arena outlives the nodes allocated from it
+        UIArena arena(4096);
+        std::shared_ptr<InteractiveUINode> root = arena.make<InteractiveUINode>();
+        for (int i = 0; i < 100; ++i) {
+            std::shared_ptr<InteractiveUINode> child = arena.make<InteractiveUINode>();
+            root->addChild(child);
+            nodes.push_back(child.get());
+        }
+        assert(arena.getAllocatedSize() >= 101 * sizeof(InteractiveUINode));
+        assert(arena.getBlockCount() > 1);
+
+        //large allocations get their own block
+        const size_t blockCount = arena.getBlockCount();
+        auto large = arena.make<std::vector<char>>(8192);
+        auto array = arena.make<std::array<char, 8192>>();
+        assert(arena.getBlockCount() == blockCount + 1);
+
+        //nodes are contiguous in creation order, within a block
+        size_t ascending = 0;
+        for (size_t i = 1; i < nodes.size(); ++i) {
+            if (nodes[i] > nodes[i - 1]) {
+                ++ascending;
+            }
+        }
+        assert(ascending + 20 >= nodes.size());
+
+        //the memory of destroyed nodes is reused
+        const size_t allocatedSize = arena.getAllocatedSize();
+        root->removeChild(root->getLastChild());
+        assert(arena.getAllocatedSize() < allocatedSize);
+        std::shared_ptr<InteractiveUINode> child = arena.make<InteractiveUINode>();
+        assert(child.get() == nodes.back());
+        assert(arena.getAllocatedSize() == allocatedSize);
+        assert(arena.getBlockCount() == blockCount + 1);
+    }
+
+    //shared and weak pointers may outlive the arena
+    std::weak_ptr<InteractiveUINode> weakNode;
+    std::shared_ptr<InteractiveUINode> sharedNode;
+    {
+        UIArena arena;
+        auto node = arena.make<InteractiveUINode>();
+        weakNode = node;
+        sharedNode = arena.make<InteractiveUINode>();
+        sharedNode->addChild(node);
+        node.reset();
+    }
+    assert(!weakNode.expired());
+    sharedNode->removeChildren();
+    assert(weakNode.expired());
+    sharedNode.reset();
+    std::weak_ptr<InteractiveUINode> copy = weakNode;
+    weakNode.reset();
+    assert(copy.expired());
+    copy.reset();
+}
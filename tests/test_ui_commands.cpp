@@ -0,0 +1,104 @@
+#include <vector>
+#include <thread>
+#include <memory>
+#include <stdexcept>
+#include <cassert>
+
+
+#include "algui/UICommandQueue.hpp"
+#include "algui/InteractiveUINode.hpp"
+
+
+using namespace algui;
+
+
+void test_ui_commands() {
+    constexpr size_t PRODUCER_COUNT = 4;
+    constexpr size_t ROW_COUNT = 500;
+
+    auto root = std::make_shared<InteractiveUINode>();
+    std::shared_ptr<UICommandQueue> queue = root->getCommandQueue();
+    assert(queue == root->getCommandQueue());
+
+    //subtrees are prepared in other threads, and added to the tree by render()
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < PRODUCER_COUNT; ++producer) {
+        producers.emplace_back([=]() {
+            UICommandBuffer buffer;
+            std::shared_ptr<InteractiveUINode> panel = buffer.createNode<InteractiveUINode>();
+            buffer.setRect(panel, Rect::rect(float(producer) * 100, 0, 100, 1000));
+            for (size_t row = 0; row < ROW_COUNT; ++row) {
+                std::shared_ptr<UINode> node = buffer.createNode();
+                buffer.setRect(node, Rect::rect(0, float(row) * 2, 100, 2));
+                buffer.addChild(panel, node);
+            }
+            buffer.addChild(root, panel);
+            assert(buffer.getCommandCount() == 2 + ROW_COUNT * 2);
+            queue->submit(std::move(buffer));
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    root->render();
+    assert(root->getChildCount() == PRODUCER_COUNT);
+    for (UINode* panel = root->getFirstChildPtr(); panel; panel = panel->getNextSiblingPtr()) {
+        assert(panel->getChildCount() == ROW_COUNT);
+        assert(panel->getLastChildPtr()->getScreenRect().top == (ROW_COUNT - 1) * 2);
+    }
+    assert(queue->applyCommands() == 0);
+
+    //consecutive additions to the same position are added as one batch
+    auto list = std::make_shared<UINode>();
+    size_t childAddedCount = 0, childrenAddedCount = 0;
+    list->addEventListener("childAdded", [&](const Event&) { ++childAddedCount; return false; });
+    list->addEventListener("childrenAdded", [&](const Event&) { ++childrenAddedCount; return false; });
+    UICommandBuffer buffer;
+    std::vector<std::shared_ptr<UINode>> items;
+    for (size_t i = 0; i < 4; ++i) {
+        items.push_back(buffer.createNode());
+    }
+    buffer.addChild(list, items[2]);
+    buffer.addChild(list, items[3]);
+    buffer.addChild(list, items[0], items[2]);
+    buffer.addChild(list, items[1], items[2]);
+    buffer.setVisible(items[3], false);
+    buffer.remove(items[3]);
+    buffer.remove(items[3]);
+    buffer.apply();
+    assert(buffer.isEmpty());
+    assert(childAddedCount == 0 && childrenAddedCount == 2);
+    assert(list->getChildCount() == 3);
+    assert(list->getChildAt(0) == items[0] && list->getChildAt(1) == items[1] && list->getChildAt(2) == items[2]);
+    assert(!items[3]->isVisible() && !items[3]->getParentPtr());
+
+    //a failed buffer discards its remaining commands, and leaves the buffers after it in the queue
+    UICommandBuffer failed;
+    failed.addChild(list, items[0]);
+    failed.setVisible(items[0], false);
+    UICommandBuffer next;
+    next.addChild(list, items[3]);
+    queue->submit(std::move(failed));
+    queue->submit(std::move(next));
+    queue->submit(UICommandBuffer());
+    bool thrown = false;
+    try {
+        queue->applyCommands();
+    }
+    catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(items[0]->isVisible());
+    assert(queue->applyCommands() == 1);
+    assert(list->getLastChild() == items[3]);
+
+    bool nullThrown = false;
+    try {
+        buffer.remove(nullptr);
+    }
+    catch (const std::invalid_argument&) {
+        nullThrown = true;
+    }
+    assert(nullThrown);
+}
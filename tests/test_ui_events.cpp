@@ -0,0 +1,209 @@
+#include <vector>
+#include <memory>
+#include <cassert>
+
+
+#include "algui/InteractiveUINode.hpp"
+#include "algui/ObjectEvent.hpp"
+
+
+using namespace algui;
+
+
+void test_ui_events() {
+    const EventType timerType("timer");
+    const EventType keyDownType("keyDown");
+
+    auto root = std::make_shared<InteractiveUINode>();
+    auto child1 = std::make_shared<InteractiveUINode>();
+    auto child2 = std::make_shared<InteractiveUINode>();
+    auto grandChild = std::make_shared<InteractiveUINode>();
+    root->addChild(child1);
+    root->addChild(child2);
+    child1->addChild(grandChild);
+    assert(!root->hasEventListenersInTree(timerType));
+
+    //adding a listener updates the masks of the ancestors
+    std::vector<int> calls;
+    auto id = grandChild->addEventListener(timerType, [&](const Event& event) { calls.push_back(1); return false; });
+    assert(grandChild->hasEventListenersInTree(timerType));
+    assert(child1->hasEventListenersInTree(timerType));
+    assert(root->hasEventListenersInTree(timerType));
+    assert(!child2->hasEventListenersInTree(timerType));
+    assert(!root->hasEventListenersInTree(keyDownType));
+
+    ALLEGRO_EVENT timerEvent{};
+    timerEvent.type = ALLEGRO_EVENT_TIMER;
+    root->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ 1 }));
+
+    //removing a listener clears the masks
+    grandChild->removeEventListener(id);
+    assert(!root->hasEventListenersInTree(timerType));
+    assert(!child1->hasEventListenersInTree(timerType));
+    root->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ 1 }));
+
+    //adding and removing children updates the masks
+    child2->addEventListener(keyDownType, [&](const Event& event) { calls.push_back(2); return false; });
+    child1->removeChild(grandChild);
+    grandChild->addEventListener(timerType, [&](const Event& event) { calls.push_back(3); return false; });
+    assert(!root->hasEventListenersInTree(timerType));
+    child2->addChild(grandChild);
+    assert(root->hasEventListenersInTree(timerType));
+    assert(root->hasEventListenersInTree(keyDownType));
+    root->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ 1, 3 }));
+    root->removeChild(child2);
+    assert(!root->hasEventListenersInTree(timerType));
+    assert(!root->hasEventListenersInTree(keyDownType));
+    root->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ 1, 3 }));
+    root->addChild(child2);
+    root->removeChildren();
+    assert(!root->hasEventListenersInTree(timerType));
+    assert(child2->hasEventListenersInTree(timerType));
+
+    //clean nodes do not prevent the masks of the dirty subtrees of their next siblings from being recomputed
+    {
+        auto r = std::make_shared<InteractiveUINode>();
+        auto a = std::make_shared<InteractiveUINode>();
+        auto b = std::make_shared<InteractiveUINode>();
+        auto c = std::make_shared<InteractiveUINode>();
+        r->addChild(a);
+        r->addChild(b);
+        b->addChild(c);
+        const auto timerId = c->addEventListener(timerType, [&](const Event& event) { return false; });
+        assert(r->hasEventListenersInTree(timerType));
+        c->removeEventListener(timerId);
+        assert(!r->hasEventListenersInTree(timerType));
+        assert(!b->hasEventListenersInTree(timerType));
+    }
+
+    //change events are created only for listeners
+    calls.clear();
+    child1->addEventListener("rectChanged", [&](const ObjectEvent<UINode>& event) { calls.push_back(event.getObject() == child1 ? 4 : 0); return false; });
+    root->addEventListener("gotFocus", [&](const ObjectEvent<InteractiveUINode>& event) { calls.push_back(event.getObject() == child1 ? 5 : 0); return false; });
+    root->addChild(child1);
+    child1->setRect(Rect::rect(0, 0, 10, 10));
+    child2->setRect(Rect::rect(0, 0, 10, 10));
+    child1->setFocused(true);
+    child2->setFocused(true);
+    assert((calls == std::vector<int>{ 4, 5 }));
+
+    //deferred change events are collapsed and dispatched before rendering
+    calls.clear();
+    child1->setDeferredChangeEvents(true);
+    child1->addEventListener("visibleChanged", [&](const ObjectEvent<UINode>& event) { calls.push_back(6); return false; });
+    child1->addEventListener("selectedChanged", [&](const ObjectEvent<InteractiveUINode>& event) { calls.push_back(event.getObject()->isSelected() ? 7 : 0); return false; });
+    for (int i = 0; i < 10; ++i) {
+        child1->setRect(Rect::rect(0, 0, 20.0f + i, 10));
+        child1->setVisible(i % 2 == 0);
+        child1->setSelected(true);
+    }
+    assert(calls.empty());
+    root->render();
+    assert((calls == std::vector<int>{ 4, 7, 6 }));
+    root->render();
+    assert((calls == std::vector<int>{ 4, 7, 6 }));
+
+    //queued events of destroyed nodes are discarded
+    auto node = std::make_shared<InteractiveUINode>();
+    node->setDeferredChangeEvents(true);
+    node->addEventListener("rectChanged", [&](const Event& event) { calls.push_back(8); return false; });
+    node->setRect(Rect::rect(0, 0, 5, 5));
+    node.reset();
+    UINode::dispatchChangeEvents();
+    assert((calls == std::vector<int>{ 4, 7, 6 }));
+}
+
+
+namespace test {
+
+
+    class Row : public InteractiveUINode {
+    public:
+        int index;
+
+        Row(int index) : index(index) {
+        }
+    };
+
+
+}
+
+
+void test_delegated_events() {
+    const EventType keyDownType("keyDown");
+    const EventType timerType("timer");
+
+    auto root = std::make_shared<InteractiveUINode>();
+    auto list = std::make_shared<InteractiveUINode>();
+    root->addChild(list);
+    for (int i = 0; i < 5; ++i) {
+        auto row = std::make_shared<test::Row>(i);
+        row->addChild(std::make_shared<InteractiveUINode>());
+        list->addChild(row);
+    }
+
+    //a class-filtered delegated listener is invoked for each row, with the row as target
+    std::vector<int> calls;
+    auto id = list->addDelegatedEventListener<test::Row>(keyDownType, [&](const KeyboardEvent& event, InteractiveUINode* target) {
+        calls.push_back(static_cast<test::Row*>(target)->index * 10 + event.getKeyCode());
+        return false;
+    });
+    ALLEGRO_EVENT keyEvent{};
+    keyEvent.type = ALLEGRO_EVENT_KEY_DOWN;
+    keyEvent.keyboard.keycode = 1;
+    root->doEvent(keyEvent);
+    assert((calls == std::vector<int>{ 1, 11, 21, 31, 41 }));
+
+    //a predicate-filtered delegated listener that stops propagation
+    calls.clear();
+    root->addDelegatedEventListener(timerType, [](const InteractiveUINode& node) { return node.as<test::Row>() && node.as<test::Row>()->index == 2; }, [&](const Event& event, InteractiveUINode* target) {
+        calls.push_back(static_cast<test::Row*>(target)->index);
+        return true;
+    });
+    ALLEGRO_EVENT timerEvent{};
+    timerEvent.type = ALLEGRO_EVENT_TIMER;
+    assert(root->doEvent(timerEvent));
+    assert((calls == std::vector<int>{ 2 }));
+
+    //removed delegated listeners are not invoked
+    calls.clear();
+    list->removeEventListener(id);
+    root->doEvent(keyEvent);
+    assert(calls.empty());
+
+    list->removeChildren();
+
+    //delegation applies to the subtrees of delegating nodes only, closest delegating ancestor first,
+    //including the ancestors of the node doEvent() is invoked on
+    auto root2 = std::make_shared<InteractiveUINode>();
+    auto outer = std::make_shared<InteractiveUINode>();
+    auto inner = std::make_shared<test::Row>(0);
+    auto other = std::make_shared<InteractiveUINode>();
+    root2->addChild(outer);
+    root2->addChild(other);
+    outer->addChild(inner);
+    inner->addChild(std::make_shared<test::Row>(1));
+    inner->addChild(std::make_shared<test::Row>(2));
+    other->addChild(std::make_shared<test::Row>(3));
+    calls.clear();
+    size_t filterCount = 0;
+    const auto filter = [&](const InteractiveUINode& node) { ++filterCount; return true; };
+    inner->addDelegatedEventListener(timerType, filter, [&](const Event& event, InteractiveUINode* target) {
+        calls.push_back(static_cast<test::Row*>(target)->index);
+        return false;
+    });
+    outer->addDelegatedEventListener(timerType, filter, [&](const Event& event, InteractiveUINode* target) {
+        calls.push_back(-1);
+        return false;
+    });
+    root2->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ -1, 1, -1, 2, -1 }));
+    assert(filterCount == 5);
+    calls.clear();
+    inner->doEvent(timerEvent);
+    assert((calls == std::vector<int>{ -1, 1, -1, 2, -1 }));
+}
@@ -0,0 +1,587 @@
+#include <vector>
+#include <memory>
+#include <string>
+#include <cassert>
+#include <iterator>
+
+
+#include "algui/UINode.hpp"
+#include "algui/DrawBatch.hpp"
+
+
+using namespace algui;
+
+
+namespace test {
+
+
+    class PaintedNode : public UINode {
+    public:
+        std::vector<std::string>* log;
+        std::string id;
+
+        PaintedNode(std::vector<std::string>* log, const std::string& id) : log(log), id(id) {
+        }
+
+    protected:
+        void paint() const override {
+            const Rect clipping = Rect::getClippingRectangle();
+            log->push_back(id + ":" + std::to_string(int(clipping.getWidth())));
+        }
+
+        void paintOverlay() const override {
+            log->push_back("/" + id);
+        }
+    };
+
+
+    class RecordedNode : public UINode {
+    public:
+        mutable size_t paintCount{ 0 };
+
+    protected:
+        void paint() const override {
+            ++paintCount;
+            const Rect& r = getScreenRect();
+            DisplayList* displayList = getDisplayList();
+            if (!displayList) {
+                return;
+            }
+            displayList->drawFilledRectangle(r.left, r.top, r.right, r.bottom, al_map_rgb(255, 255, 255));
+            displayList->drawLine(r.left, r.bottom, r.right, r.bottom, al_map_rgb(0, 0, 0), 1);
+        }
+    };
+
+
+    class BatchedNode : public UINode {
+    public:
+        ALLEGRO_BITMAP* bitmap{ nullptr };
+
+    protected:
+        void paint() const override {
+            const Rect& r = getScreenRect();
+            DrawBatch::drawFilledRectangle(r.left, r.top, r.right, r.bottom, al_map_rgb(255, 255, 255));
+            if (bitmap) {
+                DrawBatch::drawBitmap(bitmap, r.left, r.top, 0);
+            }
+        }
+    };
+
+
+}
+
+
+using namespace test;
+
+
+void test_ui_render() {
+    std::vector<std::string> log;
+    auto root = std::make_shared<PaintedNode>(&log, "root");
+    auto panel = std::make_shared<PaintedNode>(&log, "panel");
+    auto button = std::make_shared<PaintedNode>(&log, "button");
+    auto hidden = std::make_shared<PaintedNode>(&log, "hidden");
+    auto far = std::make_shared<PaintedNode>(&log, "far");
+    root->setRect(Rect::rect(0, 0, 100, 100));
+    panel->setRect(Rect::rect(10, 10, 50, 50));
+    button->setRect(Rect::rect(5, 5, 10, 10));
+    hidden->setRect(Rect::rect(0, 0, 10, 10));
+    far->setRect(Rect::rect(200, 200, 10, 10));
+    root->addChild(panel);
+    root->addChild(hidden);
+    root->addChild(far);
+    panel->addChild(button);
+    panel->setClipped(true);
+    hidden->setVisible(false);
+
+    //children are painted between the node and its overlay, within the clipping of their clipped ancestors
+    const Rect clipping = Rect::getClippingRectangle();
+    root->render();
+    assert((log == std::vector<std::string>{ "root:1048576", "panel:50", "button:50", "/button", "/panel", "far:1048576", "/far", "/root" }));
+    assert(Rect::getClippingRectangle().getWidth() == clipping.getWidth());
+    assert(button->getScreenRect().left == 15);
+
+    //moving a parent updates the screen rects of its descendants
+    panel->setRect(Rect::rect(20, 20, 50, 50));
+    log.clear();
+    root->render();
+    assert(button->getScreenRect().left == 25);
+
+    //nodes outside of the clipping rectangle are skipped
+    log.clear();
+    root->render(Rect::rect(0, 0, 80, 80));
+    assert((log == std::vector<std::string>{ "root:80", "panel:50", "button:50", "/button", "/panel", "/root" }));
+    assert(Rect::getClippingRectangle().getWidth() == clipping.getWidth());
+
+    //rendering very deep trees does not recurse
+    std::shared_ptr<UINode> deep = std::make_shared<UINode>();
+    UINode* leaf = deep.get();
+    for (size_t i = 0; i < 100000; ++i) {
+        std::shared_ptr<UINode> child = std::make_shared<UINode>();
+        child->setRect(Rect::rect(1, 1, 10, 10));
+        leaf->addChild(child);
+        leaf = child.get();
+    }
+    deep->render();
+    deep->render(Rect::rect(0, 0, 1000, 1000));
+    assert(leaf->getScreenRect().left == 100000);
+
+    //rendering through a snapshot paints the same as walking the tree, while the tree changes
+    {
+        std::vector<std::string> treeLog;
+        std::vector<std::string> snapshotLog;
+        std::vector<std::shared_ptr<PaintedNode>> treeNodes;
+        std::vector<std::shared_ptr<PaintedNode>> snapshotNodes;
+        unsigned seed = 1;
+        auto random = [&](size_t n) { seed = seed * 1103515245 + 12345; return (seed >> 8) % n; };
+        for (size_t i = 0; i < 40; ++i) {
+            treeNodes.push_back(std::make_shared<PaintedNode>(&treeLog, std::to_string(i)));
+            snapshotNodes.push_back(std::make_shared<PaintedNode>(&snapshotLog, std::to_string(i)));
+        }
+        auto apply = [&](const auto& func) {
+            func(treeNodes);
+            func(snapshotNodes);
+        };
+        apply([&, s = seed](auto& nodes) {
+            seed = s;
+            nodes[0]->setRect(Rect::rect(0, 0, 400, 400));
+            for (size_t i = 1; i < nodes.size(); ++i) {
+                nodes[i]->setRect(Rect::rect(float(random(100)), float(random(100)), float(random(100)), float(random(100))));
+                nodes[random(i)]->addChild(nodes[i]);
+            }
+        });
+        snapshotNodes[0]->setRenderSnapshotEnabled(true);
+
+        for (size_t step = 0; step < 1000; ++step) {
+            const size_t op = random(5);
+            const size_t j = 1 + random(treeNodes.size() - 1);
+            const size_t k = random(treeNodes.size());
+            const size_t value = random(100);
+            apply([&](auto& nodes) {
+                const auto& node = nodes[j];
+                UINode* parent = node->getParentPtr();
+                switch (op) {
+                    case 0:
+                        if (!node->contains(nodes[k].get())) {
+                            parent->removeChild(node);
+                            nodes[k]->addChild(node, value % 2 ? nodes[k]->getFirstChild() : nullptr);
+                        }
+                        break;
+                    case 1:
+                        parent->moveChild(node, parent->getFirstChild() != node ? parent->getFirstChild() : nullptr);
+                        break;
+                    case 2:
+                        node->setVisible(!node->isVisible());
+                        break;
+                    case 3:
+                        node->setClipped(!node->isClipped());
+                        break;
+                    case 4:
+                        node->setRect(Rect::rect(float(value), float(value), float(value), float(value)));
+                        break;
+                }
+            });
+
+            treeLog.clear();
+            snapshotLog.clear();
+            if (step % 2) {
+                treeNodes[0]->render();
+                snapshotNodes[0]->render();
+            }
+            else {
+                treeNodes[0]->render(Rect::rect(0, 0, 150, 150));
+                snapshotNodes[0]->render(Rect::rect(0, 0, 150, 150));
+            }
+            assert(treeLog == snapshotLog);
+
+            //without changes, the snapshot is culled from its screen rects
+            snapshotLog.clear();
+            if (step % 2) {
+                snapshotNodes[0]->render();
+            }
+            else {
+                snapshotNodes[0]->render(Rect::rect(0, 0, 150, 150));
+            }
+            assert(treeLog == snapshotLog);
+        }
+
+        //the snapshot contains the nodes in pre-order, along with their subtree ends and their clipping flags
+        const RenderSnapshot* snapshot = snapshotNodes[0]->getRenderSnapshot();
+        assert(snapshot->getSize() == snapshotNodes.size());
+        size_t index = 0;
+        for (UINode& node : snapshotNodes[0]->getPreorderRange()) {
+            assert(snapshot->getNodes()[index] == &node);
+            assert(snapshot->getSubtreeEnds()[index] == index + size_t(std::distance(node.getPreorderRange().begin(), node.getPreorderRange().end())));
+            assert(((snapshot->getFlags()[index] & RenderSnapshot::CLIPPED) != 0) == node.isClipped());
+            ++index;
+        }
+
+        snapshotNodes[0]->setRenderSnapshotEnabled(false);
+        assert(!snapshotNodes[0]->getRenderSnapshot());
+    }
+
+    //nested snapshots are rebuilt independently; a rebuild of the outer snapshot does not validate the inner one
+    {
+        std::vector<std::string> nestedLog;
+        auto r = std::make_shared<PaintedNode>(&nestedLog, "r");
+        auto m = std::make_shared<PaintedNode>(&nestedLog, "m");
+        auto x = std::make_shared<PaintedNode>(&nestedLog, "x");
+        r->setRect(Rect::rect(0, 0, 100, 100));
+        m->setRect(Rect::rect(0, 0, 50, 50));
+        x->setRect(Rect::rect(0, 0, 10, 10));
+        r->addChild(m);
+        m->addChild(x);
+        r->setRenderSnapshotEnabled(true);
+        m->setRenderSnapshotEnabled(true);
+        r->render();
+        m->render();
+
+        m->removeChild(x);
+        x.reset();
+        r->render();
+        nestedLog.clear();
+        m->render();
+        assert(m->getRenderSnapshot()->getSize() == 1);
+        assert((nestedLog == std::vector<std::string>{ "m:1048576", "/m" }));
+
+        auto y = std::make_shared<PaintedNode>(&nestedLog, "y");
+        y->setRect(Rect::rect(0, 0, 10, 10));
+        m->addChild(y);
+        m->render();
+        nestedLog.clear();
+        r->render();
+        assert(r->getRenderSnapshot()->getSize() == 3);
+        assert((nestedLog == std::vector<std::string>{ "r:1048576", "m:1048576", "y:1048576", "/y", "/m", "/r" }));
+
+        //the inner snapshot refreshes its screen rects after the outer walk updates its nodes
+        const Rect prevScreenRect = y->getScreenRect();
+        r->setRect(Rect::rect(5, 5, 100, 100));
+        r->render();
+        m->render();
+        assert(y->getScreenRect() != prevScreenRect);
+        assert(m->getRenderSnapshot()->getScreenRects()[1] == y->getScreenRect());
+    }
+
+    //damage regions merge overlapping rectangles, and keep a bounded number of rectangles
+    {
+        DamageRegion region(2);
+        region.add(Rect::rect(0, 0, 10, 10));
+        region.add(Rect::rect(5, 5, 10, 10));
+        region.add(Rect());
+        assert(region.getRects().size() == 1 && region.getRects()[0] == Rect::rect(0, 0, 15, 15));
+        region.add(Rect::rect(100, 0, 10, 10));
+        region.add(Rect::rect(20, 0, 10, 10));
+        assert(region.getRects().size() == 2);
+        assert(region.getRects()[0].intersects(Rect::rect(20, 0, 10, 10)) || region.getRects()[1].intersects(Rect::rect(20, 0, 10, 10)));
+        assert(!region.getRects()[0].intersects(region.getRects()[1]));
+        region.clear();
+        assert(region.isEmpty());
+    }
+
+    //damaged rendering repaints only the areas that changed
+    for (const bool snapshotEnabled : { false, true }) {
+        std::vector<std::string> damageLog;
+        auto screen = std::make_shared<PaintedNode>(&damageLog, "screen");
+        auto a = std::make_shared<PaintedNode>(&damageLog, "a");
+        auto b = std::make_shared<PaintedNode>(&damageLog, "b");
+        screen->setRect(Rect::rect(0, 0, 100, 100));
+        a->setRect(Rect::rect(0, 0, 10, 10));
+        b->setRect(Rect::rect(50, 50, 10, 10));
+        screen->addChild(a);
+        screen->addChild(b);
+        screen->setRenderSnapshotEnabled(snapshotEnabled);
+
+        //the first call paints everything
+        assert(!screen->getDamageRegion());
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:1048576", "a:1048576", "/a", "b:1048576", "/b", "/screen" }));
+        damageLog.clear();
+        screen->renderDamaged();
+        assert(damageLog.empty());
+
+        a->invalidatePaint();
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:10", "a:10", "/a", "/screen" }));
+        assert(screen->getDamageRegion()->isEmpty());
+
+        //moving a node repaints its old and new areas
+        damageLog.clear();
+        b->setRect(Rect::rect(55, 50, 10, 10));
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:15", "b:15", "/b", "/screen" }));
+
+        damageLog.clear();
+        b->setVisible(false);
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:10", "/screen" }));
+
+        damageLog.clear();
+        screen->removeChild(a);
+        b->setVisible(true);
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:10", "/screen", "screen:10", "b:10", "/b", "/screen" }));
+
+        //children that overflow an unclipped parent are repainted even if the parent is outside of the damaged area
+        auto under = std::make_shared<PaintedNode>(&damageLog, "under");
+        auto combo = std::make_shared<PaintedNode>(&damageLog, "combo");
+        auto popup = std::make_shared<PaintedNode>(&damageLog, "popup");
+        under->setRect(Rect::rect(20, 60, 10, 10));
+        combo->setRect(Rect::rect(20, 20, 10, 10));
+        popup->setRect(Rect::rect(0, 10, 10, 50));
+        screen->addChild(under);
+        screen->addChild(combo);
+        combo->addChild(popup);
+        screen->renderDamaged();
+        damageLog.clear();
+        under->invalidatePaint();
+        screen->renderDamaged();
+        assert((damageLog == std::vector<std::string>{ "screen:10", "under:10", "/under", "popup:10", "/popup", "/screen" }));
+    }
+
+    //cached subtrees are painted into a bitmap once, then the bitmap is blitted until something in the subtree changes
+    for (const bool snapshotEnabled : { false, true }) {
+        RenderCache::clear();
+        RenderCache::resetStatistics();
+        std::vector<std::string> cacheLog;
+        auto screen = std::make_shared<PaintedNode>(&cacheLog, "screen");
+        auto panel = std::make_shared<PaintedNode>(&cacheLog, "panel");
+        auto label = std::make_shared<PaintedNode>(&cacheLog, "label");
+        screen->setRect(Rect::rect(0, 0, 100, 100));
+        panel->setRect(Rect::rect(10, 10, 40, 30));
+        label->setRect(Rect::rect(5, 5, 10, 10));
+        screen->addChild(panel);
+        panel->addChild(label);
+        screen->setRenderSnapshotEnabled(snapshotEnabled);
+        panel->setCached(true);
+        assert(panel->isCached());
+
+        //the subtree is clipped to the bitmap, and the clipping of the screen is restored afterwards
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "panel:40", "label:40", "/label", "/panel", "/screen" }));
+        assert(Rect::getClippingRectangle().getWidth() == clipping.getWidth());
+        assert(Rect::getClippingOriginX() == 0 && Rect::getClippingOriginY() == 0);
+        RenderCache::Statistics statistics = RenderCache::getStatistics();
+        assert(statistics.missCount == 1 && statistics.hitCount == 0);
+        assert(statistics.bitmapCount == 1 && statistics.byteCount == 40 * 30 * 4);
+
+        cacheLog.clear();
+        screen->render();
+        screen->render(Rect::rect(0, 0, 20, 20));
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "/screen", "screen:20", "/screen" }));
+        assert(RenderCache::getStatistics().hitCount == 2);
+        assert(RenderCache::getStatistics().getHitRate() == 2.0 / 3.0);
+
+        //invalidating a descendant, scaling or moving the cached node repaints the subtree
+        cacheLog.clear();
+        label->invalidatePaint();
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "panel:40", "label:40", "/label", "/panel", "/screen" }));
+        panel->setScaling({ 2, 2 });
+        screen->render();
+        assert(label->getScreenScaling().horizontal == 2);
+        panel->setRect(Rect::rect(20, 10, 50, 30));
+        screen->render();
+        statistics = RenderCache::getStatistics();
+        assert(statistics.missCount == 4 && statistics.hitCount == 2);
+        assert(statistics.bitmapCount == 1 && statistics.byteCount == 50 * 30 * 4);
+
+        //damaged rendering blits the bitmap, unless the subtree changed
+        cacheLog.clear();
+        screen->renderDamaged();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "/screen" }));
+        cacheLog.clear();
+        label->setVisible(false);
+        screen->renderDamaged();
+        assert((cacheLog == std::vector<std::string>{ "screen:20", "panel:50", "/panel", "/screen" }));
+        label->setVisible(true);
+
+        //bitmaps that do not fit in the budget are released, and subtrees that do not fit are painted directly
+        RenderCache::setMaxByteCount(1000);
+        statistics = RenderCache::getStatistics();
+        assert(statistics.bitmapCount == 0 && statistics.byteCount == 0);
+        cacheLog.clear();
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "panel:50", "label:50", "/label", "/panel", "/screen" }));
+        assert(RenderCache::getStatistics().bitmapCount == 0);
+
+        //the least recently used bitmap is released first
+        auto panel2 = std::make_shared<PaintedNode>(&cacheLog, "panel2");
+        panel2->setRect(Rect::rect(0, 50, 50, 30));
+        panel2->setCached(true);
+        screen->addChild(panel2);
+        RenderCache::setMaxByteCount(50 * 30 * 4);
+        screen->render();
+        statistics = RenderCache::getStatistics();
+        assert(statistics.bitmapCount == 1 && statistics.byteCount == 50 * 30 * 4);
+
+        RenderCache::setMaxByteCount(RenderCache::DEFAULT_MAX_BYTE_COUNT);
+        screen->render();
+        assert(RenderCache::getStatistics().bitmapCount == 2);
+        panel->setCached(false);
+        panel2->setCached(false);
+        statistics = RenderCache::getStatistics();
+        assert(statistics.bitmapCount == 0 && statistics.byteCount == 0);
+        cacheLog.clear();
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "panel:1048576", "label:1048576", "/label", "/panel", "panel2:1048576", "/panel2", "/screen" }));
+    }
+
+    //invalidations below unbounded nodes that are culled, but whose children are painted, reach cached ancestors
+    for (const bool snapshotEnabled : { false, true }) {
+        RenderCache::clear();
+        std::vector<std::string> cacheLog;
+        auto screen = std::make_shared<PaintedNode>(&cacheLog, "screen");
+        auto a = std::make_shared<PaintedNode>(&cacheLog, "a");
+        auto b = std::make_shared<PaintedNode>(&cacheLog, "b");
+        auto c = std::make_shared<PaintedNode>(&cacheLog, "c");
+        screen->setRect(Rect::rect(0, 0, 200, 200));
+        a->setRect(Rect::rect(0, 0, 100, 100));
+        b->setRect(Rect::rect(0, 0, 0, 0));
+        c->setRect(Rect::rect(10, 10, 20, 20));
+        screen->addChild(a);
+        a->addChild(b);
+        b->addChild(c);
+        screen->setRenderSnapshotEnabled(snapshotEnabled);
+        a->setCached(true);
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "a:100", "c:100", "/c", "/a", "/screen" }));
+
+        cacheLog.clear();
+        c->invalidatePaint();
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "a:100", "c:100", "/c", "/a", "/screen" }));
+
+        cacheLog.clear();
+        c->setRect(Rect::rect(20, 20, 20, 20));
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "a:100", "c:100", "/c", "/a", "/screen" }));
+        assert(c->getScreenRect() == Rect::rect(20, 20, 20, 20));
+
+        cacheLog.clear();
+        screen->render();
+        assert((cacheLog == std::vector<std::string>{ "screen:1048576", "/screen" }));
+        a->setCached(false);
+    }
+
+    //nodes with display lists record their painting once, and replay it until they are invalidated
+    {
+        auto screen = std::make_shared<UINode>();
+        auto item = std::make_shared<RecordedNode>();
+        screen->setRect(Rect::rect(0, 0, 100, 100));
+        item->setRect(Rect::rect(10, 10, 20, 20));
+        screen->addChild(item);
+        item->setDisplayListEnabled(true);
+        assert(item->isDisplayListEnabled());
+        screen->render();
+        screen->render();
+        screen->render(Rect::rect(0, 0, 50, 50));
+        assert(item->paintCount == 1);
+        assert(item->getDisplayList()->getCommandCount() == 2);
+
+        //invalidation, moving the node or one of its ancestors and scaling record the list again
+        item->invalidatePaint();
+        screen->render();
+        assert(item->paintCount == 2);
+        screen->setRect(Rect::rect(5, 0, 100, 100));
+        screen->render();
+        assert(item->paintCount == 3);
+        item->setScaling({ 2, 2 });
+        screen->render();
+        assert(item->paintCount == 4);
+        screen->renderDamaged();
+        screen->renderDamaged();
+        assert(item->paintCount == 4);
+        assert(item->getDisplayList()->getCommandCount() == 2);
+
+        item->getDisplayList()->clear();
+        assert(item->getDisplayList()->isEmpty());
+        item->setDisplayListEnabled(false);
+        assert(!item->getDisplayList());
+        screen->render();
+        screen->render();
+        assert(item->paintCount == 6);
+    }
+
+    //primitives of consecutive nodes are drawn together; clipping changes and bitmaps flush the batch
+    {
+        auto grid = std::make_shared<UINode>();
+        grid->setRect(Rect::rect(0, 0, 1000, 1000));
+        std::vector<std::shared_ptr<BatchedNode>> cells;
+        for (size_t i = 0; i < 100; ++i) {
+            auto cell = std::make_shared<BatchedNode>();
+            cell->setRect(Rect::rect(float(i % 10 * 100), float(i / 10 * 100), 100, 100));
+            grid->addChild(cell);
+            cells.push_back(cell);
+        }
+        DrawBatch::resetStatistics();
+        grid->render();
+        DrawBatch::Statistics statistics = DrawBatch::getStatistics();
+        assert(statistics.primitiveCount == 100 && statistics.primitiveBatchCount == 1);
+
+        //setting the same clipping rectangle does not flush the batch
+        DrawBatch::resetStatistics();
+        DrawBatch::drawLine(0, 0, 10, 10, al_map_rgb(0, 0, 0), 1);
+        Rect::getClippingRectangle().setClippingRectangle();
+        assert(DrawBatch::getStatistics().primitiveBatchCount == 0);
+        DrawBatch::flush();
+        assert(DrawBatch::getStatistics().primitiveBatchCount == 1);
+
+        DrawBatch::resetStatistics();
+        cells[50]->setClipped(true);
+        grid->render();
+        assert(DrawBatch::getStatistics().primitiveBatchCount == 3);
+
+        DrawBatch::resetStatistics();
+        ALLEGRO_BITMAP* bitmap = al_create_bitmap(10, 10);
+        cells[20]->bitmap = bitmap;
+        grid->render();
+        statistics = DrawBatch::getStatistics();
+        assert(statistics.primitiveBatchCount == 4 && statistics.bitmapBatchCount == 1 && statistics.bitmapCount == 1);
+        assert(!al_is_bitmap_drawing_held());
+        cells[20]->bitmap = nullptr;
+        al_destroy_bitmap(bitmap);
+    }
+
+    //rendering without a clipping rectangle skips the nodes outside of the target bitmap
+    for (const bool snapshotEnabled : { false, true }) {
+        std::vector<std::string> cullLog;
+        auto screen = std::make_shared<PaintedNode>(&cullLog, "screen");
+        auto list = std::make_shared<PaintedNode>(&cullLog, "list");
+        auto row = std::make_shared<PaintedNode>(&cullLog, "row");
+        auto group = std::make_shared<PaintedNode>(&cullLog, "group");
+        auto item = std::make_shared<PaintedNode>(&cullLog, "item");
+        screen->setRect(Rect::rect(0, 0, 4000, 100));
+        list->setRect(Rect::rect(2000, 0, 100, 100));
+        row->setRect(Rect::rect(0, 0, 100, 10));
+        group->setRect(Rect::rect(3000, 0, 10, 10));
+        item->setRect(Rect::rect(-2900, 0, 10, 10));
+        screen->addChild(list);
+        screen->addChild(group);
+        list->addChild(row);
+        group->addChild(item);
+        list->setClipped(true);
+        screen->setRenderSnapshotEnabled(snapshotEnabled);
+
+        ALLEGRO_BITMAP* const prevTarget = al_get_target_bitmap();
+        ALLEGRO_BITMAP* const target = al_create_bitmap(1920, 1080);
+        al_set_target_bitmap(target);
+
+        //the subtree of the clipped node is skipped, whereas the children of the unclipped node are visited
+        screen->render();
+        assert((cullLog == std::vector<std::string>{ "screen:1048576", "item:1048576", "/item", "/screen" }));
+
+        //skipped nodes are updated when they come into view
+        screen->setRect(Rect::rect(0, 10, 4000, 100));
+        cullLog.clear();
+        screen->render();
+        assert(row->getScreenRect().top == 0);
+        Rect::setClippingOrigin(1900, 0);
+        cullLog.clear();
+        screen->render();
+        assert((cullLog == std::vector<std::string>{ "screen:1048576", "list:100", "row:100", "/row", "/list", "group:1048576", "/group", "/screen" }));
+        assert(row->getScreenRect().top == 10);
+        Rect::setClippingOrigin(0, 0);
+
+        al_set_target_bitmap(prevTarget);
+        al_destroy_bitmap(target);
+    }
+}